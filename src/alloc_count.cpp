@@ -0,0 +1,77 @@
+/**
+ * @file alloc_count.cpp
+ * @details This file contains the counting replacements of the global allocation operators
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "alloc_count.h"
+
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
+namespace alloc_count
+{
+    static std::atomic<uint64_t> num_allocs(0);
+
+    uint64_t get() {
+        return num_allocs.load(std::memory_order_relaxed);
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    alloc_count::num_allocs.fetch_add(1, std::memory_order_relaxed);
+
+    void* ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    alloc_count::num_allocs.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t& tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+    std::free(ptr);
+}
@@ -0,0 +1,30 @@
+/**
+ * @file alloc_count.h
+ * @details This file contains the heap allocation counter of the simulator
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef ALLOC_COUNT_H
+#define ALLOC_COUNT_H
+
+// standard includes
+#include <cstdint>
+
+/**
+ * @details Every operator new of the program is counted. The simulated request path is expected to
+ * reach a steady state without any, which the count after a warm-up shows
+ */
+namespace alloc_count
+{
+    /**
+     * @details Records issued before the steady state, buffers reach their size in them
+     */
+    const uint64_t WARMUP_RECORDS = 1 << 16;
+
+    /**
+     * @details Number of heap allocations through operator new so far, across all threads
+     */
+    uint64_t get();
+}
+
+#endif // ALLOC_COUNT_H
@@ -0,0 +1,106 @@
+/**
+ * @file async_link.cpp
+ * @details This file contains definitions of the asynchronous level link
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "async_link.h"
+
+async_link::async_link(const std::string& name, const logger& log_obj, size_t ring_batches) :
+    module(name, log_obj),
+    _ring(ring_batches),
+    _is_running(false),
+    _num_batches(0)
+{
+}
+
+void async_link::reserve(size_t max_batch)
+{
+    for (size_t i = 0; i < _ring.capacity(); i++) {
+        _ring.slot(i).reqs.reserve(max_batch);
+    }
+}
+
+void async_link::start()
+{
+    if (_is_running) {
+        return;
+    }
+
+    _is_running = true;
+    _consumer = std::thread(&async_link::forward, this);
+}
+
+void async_link::stop()
+{
+    if (!_is_running) {
+        return;
+    }
+
+    link_batch* batch = _ring.produce();
+    batch->count = 0;
+    batch->is_last = true;
+    _ring.commit();
+
+    _consumer.join();
+    _is_running = false;
+
+    log.log(this, verbose::INFO, std::to_string(_num_batches) + " batches, sender stalled " +
+        std::to_string(_ring.get_producer_stalls()) + " times on a full ring, receiver stalled " +
+        std::to_string(_ring.get_consumer_stalls()) + " times on an empty ring");
+}
+
+void async_link::forward()
+{
+    while (true)
+    {
+        link_batch* batch = _ring.consume();
+
+        if (batch->is_last)
+        {
+            batch->is_last = false;
+            _ring.release();
+            return;
+        }
+
+        put_batch_to_next(batch->reqs.data(), batch->count);
+
+        _ring.release();
+        _num_batches++;
+    }
+}
+
+void async_link::get_batch_frm_prev(mem_req* reqs, size_t num)
+{
+    if (!_is_running)
+    {
+        put_batch_to_next(reqs, num);
+        return;
+    }
+
+    // slots keep their buffers, they only grow to the largest batch seen
+    link_batch* batch = _ring.produce();
+    batch->reqs.assign(reqs, reqs + num);
+    batch->count = num;
+    batch->is_last = false;
+    _ring.commit();
+}
+
+void async_link::get_frm_prev()
+{
+    if (ifc_prev != nullptr) {
+        put_to_next(req_ptr_prev);
+    }
+}
+
+void async_link::get_frm_next()
+{
+    if (ifc_prev != nullptr) {
+        put_to_prev(resp_ptr_next);
+    }
+}
+
+async_link::~async_link()
+{
+    stop();
+}
@@ -0,0 +1,102 @@
+/**
+ * @file async_link.h
+ * @details This file contains a link running the next level of a hierarchy on its own thread
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef ASYNC_LINK_H
+#define ASYNC_LINK_H
+
+// standard includes
+#include <vector>
+#include <thread>
+#include <cstddef>
+
+// local includes
+#include <module.h>
+#include <spsc_ring.h>
+
+/**
+ * @details A batch of requests in flight between two levels
+ */
+struct link_batch
+{
+    std::vector<mem_req> reqs;
+    size_t count;
+
+    // set on the batch that stops the consumer
+    bool is_last;
+
+    link_batch() : count(0), is_last(false) {}
+};
+
+/**
+ * @details Sits between two levels and decouples them. Batches sent by the previous level are copied
+ * into a lock-free ring and handed to the next level on a dedicated thread, in the order they were
+ * sent. A batch never waits for responses, so both levels see exactly the requests and order of a
+ * synchronous run while working on different batches at the same time. Only the batch interface
+ * is decoupled, requests sent one at a time go through synchronously
+ */
+class async_link : public module
+{
+    private:
+        spsc_ring<link_batch> _ring;
+        std::thread _consumer;
+        bool _is_running;
+
+        unsigned long _num_batches;
+
+        /**
+         * @details Consumer thread, forwards batches until the last one
+         */
+        void forward();
+
+    public:
+
+        /**
+         * @details Construct a link holding up to ring_batches batches in flight
+         */
+        async_link(const std::string& name, const logger& log, size_t ring_batches = 64);
+
+        // the consumer thread refers to this object
+        async_link(const async_link&) = delete;
+        async_link& operator=(const async_link&) = delete;
+
+        /**
+         * @details Size every slot for batches of up to max_batch requests, so they are copied without
+         * allocating. Must be called before start
+         */
+        void reserve(size_t max_batch);
+
+        /**
+         * @details Start forwarding on the consumer thread, connections must be made before
+         */
+        void start();
+
+        /**
+         * @details Wait until every batch sent so far went through the next level and stop the thread
+         */
+        void stop();
+
+        /**
+         * @details Queue a batch for the next level
+         */
+        void get_batch_frm_prev(mem_req* reqs, size_t num);
+
+        /**
+         * @details Requests sent one at a time pass straight through
+         */
+        void get_frm_prev();
+
+        /**
+         * @details Responses pass straight back
+         */
+        void get_frm_next();
+
+        /**
+         * @details destructor, stops the thread if still running
+         */
+        ~async_link();
+};
+
+#endif // ASYNC_LINK_H
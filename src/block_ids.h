@@ -0,0 +1,135 @@
+/**
+ * @file block_ids.h
+ * @details This file contains the table giving dense ids to block addresses
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef BLOCK_IDS_H
+#define BLOCK_IDS_H
+
+// standard includes
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * @details Dense ids of the blocks of a stream, in order of first access. Ids are found by linear
+ * probing an open addressing table kept at most half full, which only allocates when it grows
+ */
+class block_id_table
+{
+    public:
+        // id of an empty slot
+        static constexpr uint32_t NONE = ~0u;
+
+    private:
+        struct id_slot
+        {
+            unsigned block;
+            uint32_t id;
+        };
+        std::vector<id_slot> _table;
+
+        // block of every id
+        std::vector<unsigned> _blocks;
+
+        /**
+         * @details Slot a block hashes to, Fibonacci hashing spreads the consecutive blocks of a stream
+         */
+        static size_t hash(unsigned block, size_t mask) {
+            return (size_t) ((block * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        }
+
+        /**
+         * @details Double the table
+         */
+        void grow()
+        {
+            std::vector<id_slot> table(2 * _table.size(), id_slot{0, NONE});
+            size_t mask = table.size() - 1;
+
+            for (const id_slot& slot : _table)
+            {
+                if (slot.id == NONE) {
+                    continue;
+                }
+                size_t i = hash(slot.block, mask);
+                while (table[i].id != NONE) {
+                    i = (i + 1) & mask;
+                }
+                table[i] = slot;
+            }
+
+            _table.swap(table);
+        }
+
+    public:
+
+        /**
+         * @details Table sized for about expected blocks before it first grows
+         */
+        block_id_table(size_t expected = 8)
+        {
+            size_t size = 16;
+            while (size < 2 * expected) {
+                size = size << 1;
+            }
+            _table.assign(size, id_slot{0, NONE});
+        }
+
+        /**
+         * @details Id of block, given the next free id when it was not seen yet
+         */
+        uint32_t find_or_add(unsigned block, bool& is_new)
+        {
+            size_t mask = _table.size() - 1;
+            for (size_t i = hash(block, mask); ; i = (i + 1) & mask)
+            {
+                id_slot& slot = _table[i];
+                if (slot.id == NONE)
+                {
+                    is_new = true;
+                    slot.block = block;
+                    slot.id = _blocks.size();
+                    _blocks.push_back(block);
+
+                    uint32_t id = slot.id;
+                    if (2 * _blocks.size() > _table.size()) {
+                        grow();
+                    }
+                    return id;
+                }
+                if (slot.block == block)
+                {
+                    is_new = false;
+                    return slot.id;
+                }
+            }
+        }
+
+        /**
+         * @details Forget every block, keeping the table's size
+         */
+        void clear()
+        {
+            std::fill(_table.begin(), _table.end(), id_slot{0, NONE});
+            _blocks.clear();
+        }
+
+        /**
+         * @details Number of blocks seen
+         */
+        size_t size() const {
+            return _blocks.size();
+        }
+
+        /**
+         * @details Block of every id, by id
+         */
+        const std::vector<unsigned>& get_blocks() const {
+            return _blocks;
+        }
+};
+
+#endif // BLOCK_IDS_H
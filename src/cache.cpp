@@ -6,7 +6,10 @@
 
 #include "cache.h"
 
-cache::cache()
+#include <cache_access.h>
+
+cache::cache() : _v_cache_states(0, 0), _v_victim_cache(0, 0), _cache_repl(lru_policy(0, 0)), _victim_lru(0, 0),
+    _batch_kernel(&cache::generic_kernel), _warm_kernel(&cache::generic_warm_kernel)
 {
     // TODO decide on default values
 }
@@ -14,14 +17,18 @@ cache::cache()
 cache::cache(const std::string& name, const unsigned& size, const unsigned& assoc, const unsigned& blocksize, 
     const unsigned& num_victim_blocks,
     const logger& log_obj,
-    perf_counters::cache_counters* hpm_counter) :
+    perf_counters::cache_counters* hpm_counter,
+    const REPL_POLICY& policy,
+    const uint64_t& seed) :
     module(name, log_obj),
     _size(size),
     _assoc(assoc),
     _blocksize(blocksize),
     _num_victim_blocks(num_victim_blocks),
-    _v_cache_states(size / blocksize / assoc, std::vector<cache_line_states>(assoc)),
-    _v_victim_cache(num_victim_blocks)
+    _v_cache_states(size / blocksize / assoc, assoc),
+    _v_victim_cache(num_victim_blocks > 0 ? 1 : 0, num_victim_blocks),
+    _cache_repl(make_repl_policy(policy, size / blocksize / assoc, assoc, seed)),
+    _victim_lru(num_victim_blocks > 0 ? 1 : 0, num_victim_blocks)
 {
     // construct module
 
@@ -37,10 +44,15 @@ cache::cache(const std::string& name, const unsigned& size, const unsigned& asso
     _block_bit_size = (int) std::log2(_blocksize);
     _set_index_bit_size = (int) std::log2(_num_sets);
     _is_repl_on = false;
-    _repl_line = nullptr;
+    _repl_way = tag_store::NO_WAY;
     _is_evict_on = false;
+    _is_batch_on = false;
+    _batch_pos = 0;
+    _v_origins = nullptr;
+    _is_level = false;
 
     hpm_counter_ptr = hpm_counter;
+    _set_counters = nullptr;
 
     // enable hardware for victim cache if number of blocks is greater than 0
     _is_victim_cache_en = false;
@@ -48,8 +60,11 @@ cache::cache(const std::string& name, const unsigned& size, const unsigned& asso
         _is_victim_cache_en = true;
     }
 
+    _geom = dynamic_geometry(_block_bit_size, _set_index_bit_size, _is_victim_cache_en);
+    select_kernel(policy);
+
     // logging construction
-    log.log(this, verbose::DEBUG, "Constructed " + name + " Cache");
+    log.log<verbose::DEBUG>(this, "Constructed %s Cache", name);
 }
 
 bool compare_lru_count(cache_line_states, cache_line_states);
@@ -61,515 +76,231 @@ void cache::get_frm_prev()
     if (ifc_prev != nullptr)
     {
 
-        log.log(this, verbose::DEBUG, "Received request packet " + req_ptr_prev -> get_msg_str());
-
-        // increment request counter
-        if (req_ptr_prev -> req_op_type == OP_TYPE::LOAD) {
-            hpm_counter_ptr->num_reads++;
-        }
-        else {
-            hpm_counter_ptr->num_writes++;
-        }
-
         // gather the tag and set out of the address
         unsigned address = req_ptr_prev -> addr;
 
-        // for tag and set matching 
-        unsigned req_set = get_set_num(address);
-        unsigned req_tag = get_cache_tag(address);
-        unsigned req_tag_victim = get_victim_tag(address);
-
-        log.log(this, verbose::DEBUG, "Requested Set Index: 0x" + to_hex_str(req_set) + ", Tag: 0x" + to_hex_str(req_tag));
+        log.log<verbose::DEBUG>(this, "Received request packet " MEM_REQ_FMT, req_ptr_prev -> req_op_type, address);
+        log.log<verbose::DEBUG>(this, "Requested Set Index: 0x%x, Tag: 0x%x", get_set_num(address), get_cache_tag(address));
         
         // DEBUG
         // std::getchar();
 
-        // get set
-        auto& set_content = _v_cache_states[req_set];
-        bool is_hit = false;
+        bool is_hit = std::visit([&](auto& repl) { return access(_geom, repl, req_ptr_prev); }, _cache_repl);
 
-        // loop through lines for a tag match
-        for (auto& line : set_content)
+        if (is_hit)
         {
-            // tag matcing
-            if (req_tag == line._tag && line._valid)
-            {
-                // Cache hit
-                is_hit = true;
-                log.log(this, verbose::DEBUG, "Cache Hit");
-
-                if (req_ptr_prev -> req_op_type == OP_TYPE::LOAD) 
-                {
-                    // nothing really to be done
-                } 
-                else if (req_ptr_prev -> req_op_type == OP_TYPE::STORE)
-                {
-                    // set line to dirty
-                    line._dirty = true;
-                }
-
-                // LRU stuffs happen here
-                lru_hit_update(&set_content, line);
-
-                // create a response back previous level to move to the next request
-                auto resp = new resp_msg(true, address);
-                resp_ptr_prev = resp;
-
-                put_to_prev(resp_ptr_prev);
-
-                // deque the response message
-                delete resp;
-
-                // break from the loop
-                break;
-            }
-            else
-            {
-                // TODO as part of optimization
-            }
-        }
+            // Cache hit
+            log.log<verbose::DEBUG>(this, "Cache Hit");
+            log.log<verbose::DEBUG>(this, "Updating LRU counters");
 
-        // handle a miss
-        if (!is_hit)
-        {
-            log.log(this, verbose::DEBUG, "Cache miss!");
+            // create a response back previous level to move to the next request
+            resp_msg resp(true, address);
+            resp_ptr_prev = &resp;
 
-            // increment request counter
-            if (req_ptr_prev -> req_op_type == OP_TYPE::LOAD) {
-                hpm_counter_ptr->read_misses++;
-            }
-            else {
-                hpm_counter_ptr->write_misses++;
-            }
+            put_to_prev(resp_ptr_prev);
 
-            // get invalid line to fetch the request to
-            cache_line_states* inv_line_ptr = get_invalid_line(set_content);
-
-            // Check victim cache
-            // if victim cache exists and no space in set, check through victim cache
-            if (_is_victim_cache_en && inv_line_ptr == nullptr)
-            {
-                
-                // increment number of victim cache checks
-                hpm_counter_ptr->num_swap_req++;
-
-                bool is_victim_hit = false;
-                log.log(this, verbose::DEBUG, "Looking through victim cache");
-                for (auto victim_line = _v_victim_cache.begin(); victim_line != _v_victim_cache.end(); victim_line++)
-                {
-                    if (req_tag_victim == victim_line->_tag && victim_line->_valid)
-                    {
-                        // hit in victim cache
-                        log.log(this, verbose::DEBUG, "Victim cache hit!");
-                        is_victim_hit = true;
-
-                        // set is full get least recently used line
-                        if (inv_line_ptr == nullptr) {
-
-                            log.log(this, verbose::DEBUG, "Set full, initiating LRU replacement with victim cache");
-                            
-                            // no space in set. swap with the lru line in main cache
-                            cache_line_states* lru_line = get_lru_line(set_content);
-                            
-                            // increment swap requests number
-                            hpm_counter_ptr->num_swaps++;
-
-                            swap_cache_line(req_set, lru_line, &*victim_line);
-
-                            // exchange count values
-                            std::swap(victim_line->_count, lru_line->_count);
-
-                            // set dirty if incoming request is a store
-                            if (req_ptr_prev->req_op_type == OP_TYPE::STORE) {
-                                lru_line->_dirty = true;
-                            }
-                            
-                            // Update LRU counters on hit in victim cache
-                            lru_hit_update(&_v_victim_cache, *victim_line);
-
-                            // Update LRU counters in main cache
-                            lru_repl_update(&set_content, *lru_line);
-                        }
-                        else 
-                        {
-                            // there are invalid lines, bring that line here and invalidate the one in victim cache
-                            log.log(this, verbose::FATAL, "Non-full set should not have a victim cache hit!");
-                            assert(false);
-                        }
-
-                        // done with loop
-                        break;
-                    }
-                    else {
-                        // TODO
-                        // Track states for optimization
-                    }
-                }
-
-                if (!is_victim_hit)
-                {
-                    // get an invalid line in victim cache
-                    cache_line_states* inv_victim_line_ptr = get_invalid_line(_v_victim_cache);
-
-                    // victim cache miss
-                    log.log(this, verbose::DEBUG, "Victim cache miss!");
-
-                    _repl_line = inv_victim_line_ptr;
-
-                    // set parameters accordingly to flag if replacement is needed 
-                    if (inv_victim_line_ptr == nullptr)
-                    {   
-                        log.log(this, verbose::DEBUG, "Victim cache is full. Eviction needed!");
-
-                        // get lru line from victim cache
-                        cache_line_states* victim_lru_line = get_lru_line(_v_victim_cache);
-
-                        if (victim_lru_line->_dirty)
-                        {
-                            log.log(this, verbose::DEBUG, "Line is dirty. Evicting");
-
-                            // increment writeback counter
-                            hpm_counter_ptr->num_writebacks++;
-
-                            _is_evict_on = true;
-                            // write to next level
-                            // create new request packet
-                            mem_req* evict_req = new mem_req;
-
-                            // write request to next level
-                            evict_req->req_op_type = OP_TYPE::STORE;
-                            evict_req->addr = victim_lru_line->_tag  << _block_bit_size;
-
-                            put_to_next(evict_req);
-
-                            delete evict_req;
-                            _is_evict_on = false;
-                        }
-                        else {
-                            log.log(this, verbose::DEBUG, "Line is not dirty. Invalidating");
-                        }
-
-                        // invalidate it
-                        victim_lru_line -> _valid = false;
-                    
-                        // flag set for replacement
-                        _is_repl_on = true;
-                        _repl_line = victim_lru_line;
-                    }
-                    else {
-                        // get lru line in set
-                        cache_line_states* lru_line = get_lru_line(set_content);
-
-                        // put the lru line to invalid space in cache
-                        *inv_victim_line_ptr = *lru_line;
-                        
-                        inv_victim_line_ptr->_tag = (inv_victim_line_ptr->_tag << _set_index_bit_size) | req_set;
-
-                        // lru update
-                        lru_repl_update(&_v_victim_cache, *inv_victim_line_ptr);
-
-                        // invalidate lru line
-                        lru_line -> _valid = false;
-
-                        // get new content here
-                        _repl_line = lru_line;
-                        _is_repl_on = false;
-                    }
-
-                    // request from next level
-                    if (ifc_next != nullptr)
-                    {
-                        // push request to next elvel
-                        mem_req* miss_req = new mem_req;
-
-                        miss_req->req_op_type = OP_TYPE::LOAD;
-                        miss_req->addr = req_ptr_prev->addr;
-
-                        req_ptr_next = miss_req;
-                        put_to_next(req_ptr_next);
-
-                        delete miss_req;
-                    } else {
-                        log.log(this, verbose::FATAL, "No next level connection! Check conncections");
-                    }
-                }
-            }
-            else
-            {
-                // No victim cache
-                _repl_line = inv_line_ptr;
-
-                if (inv_line_ptr == nullptr)
-                {
-                    log.log(this, verbose::DEBUG, "Set is full. Replacement needed!");
-
-                    // get lru line
-                    cache_line_states* lru_line = get_lru_line(set_content);
-
-                    if (lru_line->_dirty)
-                    {
-                        log.log(this, verbose::DEBUG, "Line is dirty. Evicting");
-                        _is_evict_on = true;
-
-                        // incrementing writeback counter
-                        hpm_counter_ptr->num_writebacks++;
-
-                        // write to next level
-                        // create new request packet
-                        mem_req* evict_req = new mem_req;
-
-                        // write request to next level
-                        evict_req->req_op_type = OP_TYPE::STORE;
-                        evict_req->addr = ((lru_line->_tag << _set_index_bit_size) | req_set) << _block_bit_size;
-
-                        put_to_next(evict_req);
-
-                        delete evict_req;
-                        _is_evict_on = false;
-                    }
-                    else {
-                        log.log(this, verbose::DEBUG, "Line is not dirty. Invalidating");
-                    }
-
-                    // invalidate it
-                    lru_line -> _valid = false;
-                    
-                    // flag set for replacement
-                    _is_repl_on = true;
-                    _repl_line = lru_line;
-                }
-                else
-                {
-                    _is_repl_on = false;
-                }
-
-                // request from next level
-                if (ifc_next != nullptr)
-                {
-                    // push request to next elvel
-                    mem_req* miss_req = new mem_req;
-
-                    miss_req->req_op_type = OP_TYPE::LOAD;
-                    miss_req->addr = req_ptr_prev->addr;
-
-                    req_ptr_next = miss_req;
-                    put_to_next(req_ptr_next);
-
-                    delete miss_req;
-                } else {
-                    log.log(this, verbose::FATAL, "No next level connection! Check conncections");
-                }
-            }
+            // the response only lives for this call
+            resp_ptr_prev = nullptr;
         }
     }
 }
 
-void cache::get_frm_next()
+void cache::get_batch_frm_prev(mem_req* reqs, size_t num)
 {
-    // getting data from next level could be for two reasons
-    // 1. miss in main cache, miss in victim cache (needs replacement with victim cache)
-    // 2. miss in main cache (does not need replacement with victim cache)
+    log.log<verbose::DEBUG>(this, "Received batch of %lu requests", num);
 
-    log.log(this, verbose::DEBUG, "Received response packet " + resp_ptr_next->get_msg_str());
+    // misses and writebacks are collected and forwarded in order once the batch is done
+    _is_batch_on = true;
+    _v_next_batch.clear();
 
-    unsigned resp_set = get_set_num(resp_ptr_next->addr);
-
-    // if evict mode is on ignore the response
-    if (_is_evict_on) {
-        return;
+    // at most a writeback and a fetch per request, so the buffer never grows within a batch. Batches larger
+    // than reserve_batch allowed for double it, so ones creeping up in size do not grow it again and again
+    if (_v_next_batch.capacity() < 2 * num) {
+        _v_next_batch.reserve(std::max(2 * num, 2 * _v_next_batch.capacity()));
     }
 
-    // if replacement flag is set
-    if (_is_repl_on)
-    {
-        if (_repl_line != nullptr)
-        {
-            // main cache set is full
-            log.log(this, verbose::DEBUG, "Replacing an LRU line");
-
-            // get lru line from main cache
-            cache_line_states* cache_lru_line = get_lru_line(_v_cache_states[resp_set]);
-
-            if (_is_victim_cache_en)
-            {
-                // swap the lru line in main cache with evicted line
-                // and invalidate the line put in main cache
-
-                // swap lines
-                swap_cache_line(resp_set, cache_lru_line, _repl_line);
-                    
-                // invalidate the line in cache
-                cache_lru_line -> _valid = false;
-
-                // update lru numbers in victim cache
-                lru_repl_update(&_v_victim_cache, *_repl_line);
-
-                // finally update the lru line with response
-                cache_lru_line ->_dirty = req_ptr_prev -> req_op_type == OP_TYPE::STORE ? true : false; 
-                cache_lru_line -> _tag = get_cache_tag(req_ptr_prev -> addr);
-                cache_lru_line -> _valid = true;
-                cache_lru_line -> _count = 0;
-                
-                lru_repl_update(&_v_cache_states[resp_set], *cache_lru_line);
-
-                _is_evict_on = false;
-
-                if (ifc_prev != nullptr) {
-                    resp_ptr_prev = resp_ptr_next;
-                    put_to_prev(resp_ptr_prev);
-                }
-            }
-            else
-            {
-                log.log(this, verbose::DEBUG, "Filling evicted line with new content");
-
-                _repl_line -> _dirty = req_ptr_prev -> req_op_type == OP_TYPE::STORE ? true : false; 
-                _repl_line -> _tag = get_cache_tag(req_ptr_prev -> addr);
-                _repl_line -> _valid = true;
-                _repl_line -> _count = 0;
+    // geometry and replacement policy are resolved once for the whole batch
+    (this->*_batch_kernel)(reqs, num);
 
-                lru_repl_update(&_v_cache_states[resp_set], *_repl_line);
+    _is_batch_on = false;
 
-                if (ifc_prev != nullptr) {
-                    resp_ptr_prev = resp_ptr_next;
-                    put_to_prev(resp_ptr_prev);
-                }
-            }
-        }
-        else {
-            assert(false);
-        }
+    if (!_v_next_batch.empty()) {
+        put_batch_to_next(_v_next_batch.data(), _v_next_batch.size());
     }
-    else 
-    {
-        
-        log.log(this, verbose::DEBUG, "Writing response block to set: 0x" + to_hex_str(resp_set));
+}
 
-        // set valid
-        _repl_line -> _valid = true;
-        
-        // update dirty or non-dirty
-        if (req_ptr_prev -> req_op_type == OP_TYPE::LOAD) {
-            _repl_line -> _dirty = false;
-        } else {
-            _repl_line -> _dirty = true;
-        }
-        
-        // update tag
-        _repl_line -> _tag = get_cache_tag(req_ptr_prev->addr);
+void cache::reserve_batch(size_t max_batch)
+{
+    _v_next_batch.reserve(2 * max_batch);
+}
 
-        auto& set_content = _v_cache_states[resp_set];
+void cache::select_kernel(REPL_POLICY policy)
+{
+    _batch_kernel = &cache::generic_kernel;
+    _warm_kernel = &cache::generic_warm_kernel;
 
-        // handle miss scenario for LRU
-        lru_repl_update(&set_content, *_repl_line);
+    // dedicated kernels are only built for LRU
+    if (policy != REPL_POLICY::LRU) {
+        return;
+    }
 
-        // put the response back to previous level 
-        if (ifc_next != nullptr) {
-            resp_ptr_prev = resp_ptr_next;
-            put_to_prev(resp_ptr_prev);
-        }
+#define CACHE_KERNEL_CASE(BLOCKSIZE, NUM_SETS, ASSOC) \
+    if (_blocksize == BLOCKSIZE && _num_sets == NUM_SETS && _assoc == ASSOC && _size == BLOCKSIZE * NUM_SETS * ASSOC) { \
+        _batch_kernel = _is_victim_cache_en ? &cache::static_kernel<static_geometry<BLOCKSIZE, NUM_SETS, ASSOC, true>> \
+                                            : &cache::static_kernel<static_geometry<BLOCKSIZE, NUM_SETS, ASSOC, false>>; \
+        _warm_kernel = _is_victim_cache_en ? &cache::static_warm_kernel<static_geometry<BLOCKSIZE, NUM_SETS, ASSOC, true>> \
+                                           : &cache::static_warm_kernel<static_geometry<BLOCKSIZE, NUM_SETS, ASSOC, false>>; \
+        log.log<verbose::DEBUG>(this, "Using kernel for " #NUM_SETS " sets, " #ASSOC " ways of " #BLOCKSIZE " bytes"); \
     }
+
+    CACHE_KERNEL_GEOMETRIES(CACHE_KERNEL_CASE)
+
+#undef CACHE_KERNEL_CASE
 }
 
-// cache operations
+void cache::generic_kernel(mem_req* reqs, size_t num)
+{
+    std::visit([&](auto& repl) { run_batch(_geom, repl, reqs, num); }, _cache_repl);
+}
 
-cache_line_states* cache::get_invalid_line(std::vector<cache_line_states>& set_content)
+template <typename GEOM>
+void cache::static_kernel(mem_req* reqs, size_t num)
 {
-    for (auto it=set_content.begin(); it != set_content.end(); it++)
-    {
-        if (!it->_valid) {
-            return &*it;
-        }
-    }
+    run_batch(GEOM(), std::get<lru_policy>(_cache_repl), reqs, num);
+}
 
-    return nullptr;
+void cache::generic_warm_kernel(const mem_req* reqs, size_t num, std::vector<mem_req>& next)
+{
+    std::visit([&](auto& repl) {
+        using POLICY = std::decay_t<decltype(repl)>;
+        lookup_batch<dynamic_geometry, POLICY, true>(_geom, repl, reqs, num, next);
+    }, _cache_repl);
 }
 
-void cache::lru_repl_update(std::vector<cache_line_states>* set_content, cache_line_states& hit_line)
+template <typename GEOM>
+void cache::static_warm_kernel(const mem_req* reqs, size_t num, std::vector<mem_req>& next)
 {
-    // reset counter for new line
-    hit_line._count = 0;
+    lookup_batch<GEOM, lru_policy, true>(GEOM(), std::get<lru_policy>(_cache_repl), reqs, num, next);
+}
 
-    // increment counters for all other lines
-    for (auto& other_line : *set_content)
+void cache::issue_to_next(OP_TYPE op, unsigned addr)
+{
+    // at most a writeback and then a fetch come out of one lookup
+    if (_is_level)
     {
-        if (other_line._tag != hit_line._tag && other_line._valid)
+        if (op == OP_TYPE::STORE)
         {
-            if (other_line._count != set_content->size() - 1) {
-                other_line._count = other_line._count + 1;
-            }
+            _level_result.evicted = true;
+            _level_result.evict_addr = addr;
+        }
+        else
+        {
+            _level_result.filled = true;
+            _level_result.fill_addr = addr;
         }
+        return;
     }
-}
-
-void cache::lru_hit_update(std::vector<cache_line_states>* set_content, cache_line_states& hit_line)
-{
-
-    log.log(this, verbose::DEBUG, "Updating LRU counters");
 
-    // get older counter
-    unsigned old_count = hit_line._count;
-    // reset counter for hit line
-    hit_line._count = 0;
-                
-    // increment counters of other lines accordingly
-    for (auto& other_line : *set_content)
+    if (_is_batch_on)
     {
-        if (other_line._tag != hit_line._tag && other_line._valid)
-        {
-            // incrememnt counters for all other lines with count less than old count of hit line
-            if (other_line._count < old_count)
-            {
-                // handle saturation
-                if (other_line._count != set_content->size()) {
-                    other_line._count = other_line._count + 1;
-                }
-            }
+        _v_next_batch.emplace_back(op, addr);
+        if (_v_origins != nullptr) {
+            _v_origins->push_back(_batch_pos);
         }
+        return;
     }
+
+    // create new request packet, it only lives for this call
+    mem_req next_req(op, addr);
+
+    req_ptr_next = &next_req;
+    put_to_next(req_ptr_next);
+
+    req_ptr_next = nullptr;
 }
 
-cache_line_states* cache::get_lru_line(std::vector<cache_line_states>& set_content)
+void cache::get_frm_next()
 {
-    unsigned max_count = 0;
-    cache_line_states* lru_line_ptr = nullptr;
+    // getting data from next level could be for two reasons
+    // 1. miss in main cache, miss in victim cache (needs replacement with victim cache)
+    // 2. miss in main cache (does not need replacement with victim cache)
 
-    for (auto line = set_content.begin(); line != set_content.end(); line++)
-    {
-        if (line->_count >= max_count && line->_valid) {
-            lru_line_ptr = &*line;
-            max_count = line->_count;
-        }
+    log.log<verbose::DEBUG>(this, "Received response packet " RESP_MSG_FMT, resp_ptr_next->ready, resp_ptr_next->addr);
+
+    // if evict mode is on ignore the response
+    // batches are filled without waiting for a response
+    if (_is_evict_on || _is_batch_on) {
+        return;
     }
 
-    return lru_line_ptr;
+    std::visit([&](auto& repl) { fill_line(_geom, repl, req_ptr_prev); }, _cache_repl);
+
+    // put the response back to previous level 
+    if (ifc_prev != nullptr) {
+        resp_ptr_prev = resp_ptr_next;
+        put_to_prev(resp_ptr_prev);
+    }
 }
 
-void cache::swap_cache_line(unsigned cache_set, cache_line_states* cache_line_ptr, cache_line_states* victim_line_ptr)
+// cache operations
+
+void cache::swap_cache_line(unsigned cache_set, unsigned cache_way, unsigned victim_way)
 {
     // update tag appropriately in main and victim cache
-    cache_line_ptr -> _tag = (cache_line_ptr -> _tag << _set_index_bit_size) | cache_set;
-    victim_line_ptr -> _tag = victim_line_ptr -> _tag >> _set_index_bit_size;
+    unsigned cache_tag = (_v_cache_states.get_tag(cache_set, cache_way) << _set_index_bit_size) | cache_set;
+    unsigned victim_tag = _v_victim_cache.get_tag(0, victim_way) >> _set_index_bit_size;
+
+    bool cache_valid = _v_cache_states.is_valid(cache_set, cache_way);
+    bool cache_dirty = _v_cache_states.is_dirty(cache_set, cache_way);
 
     // swap data
-    std::swap(*cache_line_ptr, *victim_line_ptr);
+    _v_cache_states.set_tag(cache_set, cache_way, victim_tag);
+    _v_cache_states.set_valid(cache_set, cache_way, _v_victim_cache.is_valid(0, victim_way));
+    _v_cache_states.set_dirty(cache_set, cache_way, _v_victim_cache.is_dirty(0, victim_way));
+
+    _v_victim_cache.set_tag(0, victim_way, cache_tag);
+    _v_victim_cache.set_valid(0, victim_way, cache_valid);
+    _v_victim_cache.set_dirty(0, victim_way, cache_dirty);
+}
+
+template <typename POLICY>
+cache_line_states cache::get_line(const tag_store& store, const POLICY& repl, unsigned set, unsigned way) const
+{
+    cache_line_states line;
+    line._valid = store.is_valid(set, way);
+    line._dirty = store.is_dirty(set, way);
+    line._tag = store.get_tag(set, way);
+
+    // the count of a line is its eviction rank, for LRU the recency among the valid lines of its set
+    line._count = line._valid ? repl.rank(set, way) : 0;
+    return line;
 }
 
 // utility functions
 
+void cache::set_origin_log(std::vector<uint32_t>* origins)
+{
+    _v_origins = origins;
+}
+
+unsigned cache::get_set_shard(unsigned set, unsigned num_shards) const
+{
+    return (uint64_t) set * num_shards / _num_sets;
+}
+
 unsigned cache::get_set_num(unsigned addr)
 {
-    return (addr >> _block_bit_size) & ( (int) std::pow(2, _set_index_bit_size) - 1);
+    return _geom.set_num(addr);
 }
 
 unsigned cache::get_cache_tag(unsigned addr)
 {
-    return addr >> (_block_bit_size + _set_index_bit_size);
+    return _geom.cache_tag(addr);
 }
 
 unsigned cache::get_victim_tag(unsigned addr)
 {
-    return addr >> _block_bit_size;
+    return _geom.victim_tag(addr);
 }
 
 bool compare_lru_count(cache_line_states line1, cache_line_states line2)
@@ -578,13 +309,23 @@ bool compare_lru_count(cache_line_states line1, cache_line_states line2)
 }
 
 void cache::print()
+{
+    print(std::vector<cache*>(1, this));
+}
+
+void cache::print(const std::vector<cache*>& shards)
 {
     std::cout << "===== " << name << " contents =====" << std::endl;
-    unsigned set_count = 0;
 
-    for (auto set : _v_cache_states)
+    for (unsigned set_count = 0; set_count < _num_sets; set_count++)
     {
-        std::vector<cache_line_states> temp_set = set;
+        // the set is printed from the shard that simulated it
+        const cache* owner = shards[get_set_shard(set_count, shards.size())];
+
+        std::vector<cache_line_states> temp_set;
+        for (unsigned way = 0; way < _assoc; way++) {
+            temp_set.push_back(std::visit([&](const auto& repl) { return owner->get_line(owner->_v_cache_states, repl, set_count, way); }, owner->_cache_repl));
+        }
         std::sort(temp_set.begin(), temp_set.end(), compare_lru_count);
         std::cout << " set " << set_count << ":  ";
         for (auto line : temp_set)
@@ -601,14 +342,15 @@ void cache::print()
             std::cout << "  ";
         }
         std::cout << std::endl;
-
-        set_count = set_count + 1;
     }
     std::cout << std::endl;
     
     if (_is_victim_cache_en)
     {
-        std::vector<cache_line_states> temp_set = _v_victim_cache;
+        std::vector<cache_line_states> temp_set;
+        for (unsigned way = 0; way < _num_victim_blocks; way++) {
+            temp_set.push_back(get_line(_v_victim_cache, _victim_lru, 0, way));
+        }
         std::sort(temp_set.begin(), temp_set.end(), compare_lru_count);
         std::cout << " set 0:  ";
         for (auto line : temp_set)
@@ -628,10 +370,158 @@ void cache::print()
     }
 }
 
+void cache::warm(const mem_req* reqs, size_t num, std::vector<mem_req>& next)
+{
+    // run as a level, so the next level is reported instead of called
+    bool is_level = _is_level;
+    _is_level = true;
+
+    (this->*_warm_kernel)(reqs, num, next);
+
+    _is_level = is_level;
+}
+
+bool cache::probe(unsigned addr, bool& is_dirty) const
+{
+    unsigned set = _geom.set_num(addr);
+    int way = _v_cache_states.find(set, _geom.cache_tag(addr));
+    if (way == tag_store::NO_WAY) {
+        return false;
+    }
+
+    is_dirty = _v_cache_states.is_dirty(set, way);
+    return true;
+}
+
+bool cache::invalidate(unsigned addr, bool& was_dirty)
+{
+    unsigned set = _geom.set_num(addr);
+    int way = _v_cache_states.find(set, _geom.cache_tag(addr));
+    if (way == tag_store::NO_WAY) {
+        return false;
+    }
+
+    was_dirty = _v_cache_states.is_dirty(set, way);
+    _v_cache_states.set_valid(set, way, false);
+    _v_cache_states.set_dirty(set, way, false);
+    std::visit([&](auto& repl) { repl.on_invalidate(set, way); }, _cache_repl);
+
+    return true;
+}
+
+bool cache::downgrade(unsigned addr)
+{
+    unsigned set = _geom.set_num(addr);
+    int way = _v_cache_states.find(set, _geom.cache_tag(addr));
+    if (way == tag_store::NO_WAY || !_v_cache_states.is_dirty(set, way)) {
+        return false;
+    }
+
+    _v_cache_states.set_dirty(set, way, false);
+    return true;
+}
+
+void cache::enable_set_counters()
+{
+    hpm_counter_ptr->sets.assign(_num_sets, perf_counters::set_counters{0, 0, 0, 0, 0, 0});
+    _set_counters = hpm_counter_ptr->sets.data();
+}
+
+void cache::enable_miss_classes()
+{
+    // the shadow has the blocks of the main cache, a victim cache hit is a miss like any other
+    _classifier.reset(new miss_classifier(_num_blocks));
+    hpm_counter_ptr->is_classified = true;
+}
+
+void cache::save(ckpt_writer& out) const
+{
+    const perf_counters::cache_counters& c = *hpm_counter_ptr;
+    uint64_t counters[10] = {c.num_reads, c.read_misses, c.num_writes, c.write_misses, c.num_swap_req, c.num_swaps, c.num_writebacks,
+                             c.compulsory_misses, c.capacity_misses, c.conflict_misses};
+    out.put_array(counters, 10);
+
+    // per set counters when they are on, an empty array otherwise
+    out.put_vec(c.sets);
+
+    _v_cache_states.save(out);
+    _v_victim_cache.save(out);
+
+    out.put<uint32_t>(_cache_repl.index());
+    std::visit([&](const auto& repl) { repl.save(out); }, _cache_repl);
+    _victim_lru.save(out);
+
+    // the classifier state when misses are classified
+    out.put<uint8_t>(_classifier != nullptr);
+    if (_classifier != nullptr) {
+        _classifier->save(out);
+    }
+}
+
+bool cache::restore(ckpt_reader& in)
+{
+    uint64_t counters[10];
+    uint64_t num_sets = 0;
+    if (!in.get_array(counters, 10) || !in.get(num_sets) || (num_sets != 0 && num_sets != _num_sets)) {
+        return in.fail();
+    }
+
+    // per set counters are taken when they are on in both runs and dropped when only the checkpoint
+    // has them, the checkpoint header refuses the other way round
+    if (num_sets != 0 && _set_counters == nullptr) {
+        log.log(this, verbose::WARN, "Checkpoint holds per set counters, dropping them as this run has no --set-stats");
+    }
+    std::vector<perf_counters::set_counters> sets(num_sets);
+    if (!in.get_array(sets.data(), sets.size()) || !_v_cache_states.restore(in) || !_v_victim_cache.restore(in) ||
+        !in.expect<uint32_t>(_cache_repl.index())) {
+        return false;
+    }
+
+    uint8_t is_classified = 0;
+    if (!std::visit([&](auto& repl) { return repl.restore(in); }, _cache_repl) || !_victim_lru.restore(in) ||
+        !in.get(is_classified)) {
+        return false;
+    }
+
+    // a classifier taken along is restored, or read past when this run does not classify
+    if (is_classified)
+    {
+        if (_classifier == nullptr) {
+            log.log(this, verbose::WARN, "Checkpoint holds miss classes, dropping them as this run has no --classify-misses");
+        }
+
+        miss_classifier dropped(_num_blocks);
+        miss_classifier* target = _classifier != nullptr ? _classifier.get() : &dropped;
+        if (!target->restore(in)) {
+            return false;
+        }
+    }
+    else if (_classifier != nullptr) {
+        return in.fail();
+    }
+
+    perf_counters::cache_counters& c = *hpm_counter_ptr;
+    c.num_reads = counters[0];
+    c.read_misses = counters[1];
+    c.num_writes = counters[2];
+    c.write_misses = counters[3];
+    c.num_swap_req = counters[4];
+    c.num_swaps = counters[5];
+    c.num_writebacks = counters[6];
+    c.compulsory_misses = counters[7];
+    c.capacity_misses = counters[8];
+    c.conflict_misses = counters[9];
+
+    if (_set_counters != nullptr && num_sets == _num_sets) {
+        std::copy(sets.begin(), sets.end(), _set_counters);
+    }
+
+    return true;
+}
 
 // cache destructor
 
 cache::~cache()
 {
 
-}
+}
\ No newline at end of file
@@ -8,6 +8,8 @@
 #define CACHE_H
 
 #include <vector>
+#include <memory>
+#include <variant>
 #include <algorithm>
 #include <cstdio>
 #include <string>
@@ -17,7 +19,15 @@
 
 #include <module.h>
 #include <perf_counters.h>
+#include <tag_store.h>
+#include <repl_policy.h>
+#include <cache_geometry.h>
+#include <checkpoint.h>
+#include <miss_class.h>
 
+/**
+ * @details Snapshot of one line, as held by the tag store
+ */
 struct cache_line_states
 {
     // status bits
@@ -30,6 +40,25 @@ struct cache_line_states
     cache_line_states() : _valid(false), _dirty(false), _tag(0), _count(0) {}
 };
 
+/**
+ * @details Outcome of one lookup in a level of a static hierarchy, with the requests it sends on in order.
+ * Only a miss sends anything on, the rest is not meaningful on a hit
+ */
+struct access_result
+{
+    bool hit;
+
+    // dirty block written back to the next level
+    bool evicted;
+    unsigned evict_addr;
+
+    // block fetched from the next level on a miss
+    bool filled;
+    unsigned fill_addr;
+
+    access_result() : hit(false), evicted(false), evict_addr(0), filled(false), fill_addr(0) {}
+};
+
 class cache : public module
 {
     private:
@@ -47,11 +76,25 @@ class cache : public module
 
         // cache replacement helper data members
         bool _is_repl_on;
-        cache_line_states* _repl_line;
+        int _repl_way;
 
         // eviction mode
         bool _is_evict_on;
 
+        // batch mode, next level requests are collected instead of sent
+        bool _is_batch_on;
+        std::vector<mem_req> _v_next_batch;
+
+        // position in the current batch of the request being simulated
+        size_t _batch_pos;
+
+        // if set, the batch position causing each queued next level request is appended here
+        std::vector<uint32_t>* _v_origins;
+
+        // level of a static hierarchy, next level requests are reported in the lookup result instead of sent
+        bool _is_level;
+        access_result _level_result;
+
         // victim cache
         bool _is_victim_cache_en;
         unsigned _num_victim_blocks;
@@ -59,38 +102,115 @@ class cache : public module
         // performance counter
         perf_counters::cache_counters* hpm_counter_ptr;
 
-        // cache states
-        std::vector<std::vector<cache_line_states>> _v_cache_states;
+        // per set counters of hpm_counter_ptr, null unless turned on
+        perf_counters::set_counters* _set_counters;
 
-        // victim cache
-        std::vector<cache_line_states> _v_victim_cache;
+        // 3C classifier of the misses, null unless turned on
+        std::unique_ptr<miss_classifier> _classifier;
+
+        // cache states, all sets in one flat store
+        tag_store _v_cache_states;
+
+        // victim cache, a single fully associative set
+        tag_store _v_victim_cache;
+
+        // replacement state of main cache
+        repl_policy _cache_repl;
+
+        // victim cache replacement is always LRU
+        lru_policy _victim_lru;
+
+        // run time geometry for the generic path
+        dynamic_geometry _geom;
+
+        // batch loop picked for this geometry and policy at construction
+        void (cache::*_batch_kernel)(mem_req*, size_t);
+
+        // fast-forward loop picked along with it
+        void (cache::*_warm_kernel)(const mem_req*, size_t, std::vector<mem_req>&);
 
         // Private member functions
 
         /**
-         * @details Get the first invalid line
+         * @details Function to swap lines between main cache and victim cache
          */
-        cache_line_states* get_invalid_line(std::vector<cache_line_states>& set_content);
+        void swap_cache_line(unsigned cache_set, unsigned cache_way, unsigned victim_way);
 
         /**
-         * @details LRU update on replacement
+         * @details Gather the state of one line for printing
          */
-        void lru_repl_update(std::vector<cache_line_states>* set_content, cache_line_states& hit_line);
+        template <typename POLICY>
+        cache_line_states get_line(const tag_store& store, const POLICY& repl, unsigned set, unsigned way) const;
 
         /**
-         * @details Update counters of a line based on a hit
+         * @details Pick a kernel compiled for this geometry if there is one, the generic one otherwise
          */
-        void lru_hit_update(std::vector<cache_line_states>* set_content, cache_line_states& hit_line);
+        void select_kernel(REPL_POLICY policy);
 
         /**
-         * @details Get least recently used line
+         * @details Batch loop for any geometry and policy
          */
-        cache_line_states* get_lru_line(std::vector<cache_line_states>& set_content);
+        void generic_kernel(mem_req* reqs, size_t num);
 
         /**
-         * @details Function to swap lines between main cache and victim cache
+         * @details Batch loop for a geometry fixed at compile time with LRU replacement
+         */
+        template <typename GEOM>
+        void static_kernel(mem_req* reqs, size_t num);
+
+        /**
+         * @details Fast-forward loops for any geometry and policy, and for a fixed geometry with LRU
+         */
+        void generic_warm_kernel(const mem_req* reqs, size_t num, std::vector<mem_req>& next);
+
+        template <typename GEOM>
+        void static_warm_kernel(const mem_req* reqs, size_t num, std::vector<mem_req>& next);
+
+        template <typename GEOM, typename POLICY>
+        void run_batch(const GEOM& geom, POLICY& repl, mem_req* reqs, size_t num);
+
+        /**
+         * @details Look up a request, updating counters and line states. Returns true on a hit in the main cache
+         * The request path is compiled once per geometry and replacement policy, and always inlined into
+         * the loop driving it. IS_WARM compiles a path updating line and replacement states only, without
+         * counters or messages
+         */
+        template <typename GEOM, typename POLICY, bool IS_WARM = false>
+        __attribute__((always_inline)) inline bool access(const GEOM& geom, POLICY& repl, const mem_req* req);
+
+        /**
+         * @details Handle a miss in the main cache through the victim cache and the next level
+         */
+        template <typename GEOM, typename POLICY, bool IS_WARM>
+        void handle_miss(const GEOM& geom, POLICY& repl, const mem_req* req, unsigned req_set);
+
+        /**
+         * @details Request the missing block from the next level
          */
-        void swap_cache_line(unsigned cache_set, cache_line_states* cache_line_ptr, cache_line_states* victim_line_ptr);
+        template <typename GEOM, typename POLICY, bool IS_WARM>
+        void fetch_from_next(const GEOM& geom, POLICY& repl, const mem_req* req);
+
+        /**
+         * @details Send a request to the next level, or queue it while a batch is processed
+         */
+        void issue_to_next(OP_TYPE op, unsigned addr);
+
+        /**
+         * @details Write the block fetched for req into the line picked by handle_miss
+         */
+        template <typename GEOM, typename POLICY, bool IS_WARM = false>
+        void fill_line(const GEOM& geom, POLICY& repl, const mem_req* req);
+
+        /**
+         * @details DEBUG message of the request path, compiled out of the warm path
+         */
+        template <bool IS_WARM, typename... ARGS>
+        void debug(const char* fmt, const ARGS&... args)
+        {
+            if constexpr (!IS_WARM) {
+                log.log<verbose::DEBUG>(this, fmt, args...);
+            }
+        }
  
     public:
 
@@ -105,7 +225,9 @@ class cache : public module
         cache(const std::string& name, const unsigned& size, const unsigned& assoc, const unsigned& blocksize, 
             const unsigned& num_victim_blocks,
             const logger& log,
-            perf_counters::cache_counters* hpm_counter
+            perf_counters::cache_counters* hpm_counter,
+            const REPL_POLICY& policy = REPL_POLICY::LRU,
+            const uint64_t& seed = 1
         );
 
         /**
@@ -120,6 +242,18 @@ class cache : public module
          */
         void get_frm_prev();
 
+        /**
+         * @details This overriding function runs a whole batch of requests from the previous level and
+         * forwards the resulting misses and writebacks to the next level as one batch
+         */
+        void get_batch_frm_prev(mem_req* reqs, size_t num);
+
+        /**
+         * @details Size the outgoing batch for incoming batches of up to max_batch requests, so running
+         * them does not allocate
+         */
+        void reserve_batch(size_t max_batch);
+
         /**
          * @details This overriding function takes response from the next level in hierarchy
          */
@@ -142,11 +276,131 @@ class cache : public module
          */
         unsigned get_set_num(unsigned addr);
 
+        /**
+         * @details Make this cache a level of a static hierarchy, which is only driven through lookup
+         */
+        void set_static_level(bool enable) {
+            _is_level = enable;
+        }
+
+        /**
+         * @details Look up one request as a level of a static hierarchy. The line is filled right away
+         * and nothing is sent to the next level, the writeback and fetch it needs are returned instead,
+         * valid until the next lookup. Defined in cache_access.h
+         */
+        template <typename GEOM, typename POLICY>
+        const access_result& lookup(const GEOM& geom, POLICY& repl, const mem_req& req);
+
+        /**
+         * @details Look up a batch as a level run on its own, appending the writebacks and fetches for the
+         * next level to next in order. Fast-forwarding warms with it, the shared L2 of a multi-core run
+         * looks up its quanta with it. Defined in cache_access.h
+         */
+        template <typename GEOM, typename POLICY, bool IS_WARM = false>
+        void lookup_batch(const GEOM& geom, POLICY& repl, const mem_req* reqs, size_t num, std::vector<mem_req>& next);
+
+        /**
+         * @details Run time geometry of the main cache
+         */
+        const dynamic_geometry& get_geometry() const {
+            return _geom;
+        }
+
+        /**
+         * @details Replacement state of the main cache
+         */
+        repl_policy& get_repl_policy() {
+            return _cache_repl;
+        }
+
+        /**
+         * @details While origins is set, every request a batch sends to the next level appends the
+         * position within its batch of the request that caused it. nullptr stops logging
+         */
+        void set_origin_log(std::vector<uint32_t>* origins);
+
+        /**
+         * @details Number of sets of the main cache
+         */
+        unsigned get_num_sets() const {
+            return _num_sets;
+        }
+
+        /**
+         * @details Shard simulating a set when the sets are split into num_shards contiguous slices
+         */
+        unsigned get_set_shard(unsigned set, unsigned num_shards) const;
+
+        /**
+         * @details Run a batch through the line and replacement states only, as fast-forwarding does: no
+         * counters, no messages and nothing sent to the next level. The writebacks and fetches the next
+         * level has to see are appended to next in order
+         */
+        void warm(const mem_req* reqs, size_t num, std::vector<mem_req>& next);
+
+        /**
+         * @details Whether the main cache holds the block of addr, and if it does whether it is dirty
+         */
+        bool probe(unsigned addr, bool& is_dirty) const;
+
+        /**
+         * @details Drop the block of addr from the main cache, as a coherence invalidation does. False if
+         * it is not held, otherwise was_dirty tells if the copy was modified
+         */
+        bool invalidate(unsigned addr, bool& was_dirty);
+
+        /**
+         * @details Make the block of addr clean, as a modified copy downgraded to shared. False if it is not
+         * held dirty
+         */
+        bool downgrade(unsigned addr);
+
+        /**
+         * @details Count hits, misses and writebacks of every set from now on, in the sets of the counters
+         */
+        void enable_set_counters();
+
+        /**
+         * @details Classify misses as compulsory, capacity or conflict from now on, in the counters and
+         * the per set counters
+         */
+        void enable_miss_classes();
+
+        bool has_set_counters() const {
+            return _set_counters != nullptr;
+        }
+
+        bool has_miss_classes() const {
+            return _classifier != nullptr;
+        }
+
+        /**
+         * @details Account an access to a block of set for the classifier, counting its class on a miss
+         */
+        template <bool IS_WARM>
+        void classify(unsigned block, unsigned set, bool is_miss);
+
+        /**
+         * @details Write the line states, replacement states and counters of the main and victim cache
+         */
+        void save(ckpt_writer& out) const;
+
+        /**
+         * @details Read back what save wrote for a cache of the same configuration, false if it does not match
+         */
+        bool restore(ckpt_reader& in);
+
         /**
          * @details This function prints cache contents
          */
         void print();
 
+        /**
+         * @details Print the contents of a cache simulated as shards of identical caches, taking
+         * every set from the shard owning it
+         */
+        void print(const std::vector<cache*>& shards);
+
         // CPU operations
 
         /**
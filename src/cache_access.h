@@ -0,0 +1,428 @@
+/**
+ * @file cache_access.h
+ * @details This file contains the templated request path of the cache. It is included by every
+ * translation unit instantiating it, so a static hierarchy can inline it into its levels
+ * @author Edwin Joy edwin7026@gmail.com
+ **/
+
+#ifndef CACHE_ACCESS_H
+#define CACHE_ACCESS_H
+
+#include <cache.h>
+
+template <typename GEOM, typename POLICY>
+void cache::run_batch(const GEOM& geom, POLICY& repl, mem_req* reqs, size_t num)
+{
+    for (size_t i = 0; i < num; i++)
+    {
+        _batch_pos = i;
+        access(geom, repl, &reqs[i]);
+    }
+}
+
+template <typename GEOM, typename POLICY, bool IS_WARM>
+bool cache::access(const GEOM& geom, POLICY& repl, const mem_req* req)
+{
+    // increment request counter
+    if constexpr (!IS_WARM)
+    {
+        if (req -> req_op_type == OP_TYPE::LOAD) {
+            hpm_counter_ptr->num_reads++;
+        }
+        else {
+            hpm_counter_ptr->num_writes++;
+        }
+    }
+
+    // gather the tag and set out of the address
+    unsigned address = req -> addr;
+
+    // for tag and set matching 
+    unsigned req_set = geom.set_num(address);
+    unsigned req_tag = geom.cache_tag(address);
+
+    // tag match across all ways of the set
+    int hit_way = geom.find(_v_cache_states, req_set, req_tag);
+
+    if (hit_way != tag_store::NO_WAY)
+    {
+        if (req -> req_op_type == OP_TYPE::STORE)
+        {
+            // set line to dirty
+            _v_cache_states.set_dirty(req_set, hit_way, true);
+        }
+
+        // replacement stuffs happen here
+        repl.on_hit(req_set, hit_way);
+
+        if (_classifier != nullptr) {
+            classify<IS_WARM>(address >> geom.block_bits(), req_set, false);
+        }
+
+        if constexpr (!IS_WARM)
+        {
+            if (_set_counters != nullptr) {
+                _set_counters[req_set].hits++;
+            }
+        }
+
+        return true;
+    }
+
+    // increment request counter
+    if constexpr (!IS_WARM)
+    {
+        if (req -> req_op_type == OP_TYPE::LOAD) {
+            hpm_counter_ptr->read_misses++;
+        }
+        else {
+            hpm_counter_ptr->write_misses++;
+        }
+
+        if (_set_counters != nullptr) {
+            _set_counters[req_set].misses++;
+        }
+    }
+
+    if (_classifier != nullptr) {
+        classify<IS_WARM>(address >> geom.block_bits(), req_set, true);
+    }
+
+    handle_miss<GEOM, POLICY, IS_WARM>(geom, repl, req, req_set);
+
+    return false;
+}
+
+template <bool IS_WARM>
+void cache::classify(unsigned block, unsigned set, bool is_miss)
+{
+    // the shadow follows every access, fast-forwarding included
+    MISS_CLASS miss_class = _classifier->access(block);
+
+    if constexpr (!IS_WARM)
+    {
+        if (!is_miss) {
+            return;
+        }
+
+        perf_counters::cache_counters& c = *hpm_counter_ptr;
+        switch (miss_class)
+        {
+            case MISS_CLASS::COMPULSORY :
+                c.compulsory_misses++;
+                if (_set_counters != nullptr) {
+                    _set_counters[set].compulsory++;
+                }
+                break;
+            case MISS_CLASS::CAPACITY :
+                c.capacity_misses++;
+                if (_set_counters != nullptr) {
+                    _set_counters[set].capacity++;
+                }
+                break;
+            default :
+                c.conflict_misses++;
+                if (_set_counters != nullptr) {
+                    _set_counters[set].conflict++;
+                }
+                break;
+        }
+    }
+}
+
+template <typename GEOM, typename POLICY, bool IS_WARM>
+void cache::handle_miss(const GEOM& geom, POLICY& repl, const mem_req* req, unsigned req_set)
+{
+    debug<IS_WARM>("Cache miss!");
+
+    _level_result.evicted = false;
+    _level_result.filled = false;
+
+    // get invalid line to fetch the request to
+    int inv_way = geom.find_invalid(_v_cache_states, req_set);
+
+    // Check victim cache
+    // if victim cache exists and no space in set, check through victim cache
+    if (geom.has_victim_cache() && inv_way == tag_store::NO_WAY)
+    {
+        // increment number of victim cache checks
+        if constexpr (!IS_WARM) {
+            hpm_counter_ptr->num_swap_req++;
+        }
+
+        debug<IS_WARM>("Looking through victim cache");
+        int victim_way = _v_victim_cache.find(0, geom.victim_tag(req -> addr));
+
+        if (victim_way != tag_store::NO_WAY)
+        {
+            // hit in victim cache
+            debug<IS_WARM>("Victim cache hit!");
+
+            debug<IS_WARM>("Set full, initiating LRU replacement with victim cache");
+            
+            // no space in set. swap with the line to replace in main cache
+            int evict_way = repl.victim(req_set);
+            
+            // increment swap requests number
+            if constexpr (!IS_WARM) {
+                hpm_counter_ptr->num_swaps++;
+            }
+
+            // recency stays with the line slots, both are refreshed below
+            swap_cache_line(req_set, evict_way, victim_way);
+
+            // set dirty if incoming request is a store
+            if (req->req_op_type == OP_TYPE::STORE) {
+                _v_cache_states.set_dirty(req_set, evict_way, true);
+            }
+            
+            // Update LRU on hit in victim cache
+            _victim_lru.on_hit(0, victim_way);
+
+            // Update replacement state in main cache
+            repl.on_fill(req_set, evict_way);
+        }
+        else
+        {
+            // get an invalid line in victim cache
+            int inv_victim_way = _v_victim_cache.find_invalid(0);
+
+            // victim cache miss
+            debug<IS_WARM>("Victim cache miss!");
+
+            // set parameters accordingly to flag if replacement is needed 
+            if (inv_victim_way == tag_store::NO_WAY)
+            {   
+                debug<IS_WARM>("Victim cache is full. Eviction needed!");
+
+                // get lru line from victim cache, which is always LRU
+                int victim_evict_way = _victim_lru.victim(0);
+
+                if (_v_victim_cache.is_dirty(0, victim_evict_way))
+                {
+                    debug<IS_WARM>("Line is dirty. Evicting");
+
+                    // increment writeback counter
+                    if constexpr (!IS_WARM) {
+                        hpm_counter_ptr->num_writebacks++;
+                        if (_set_counters != nullptr) {
+                            _set_counters[req_set].writebacks++;
+                        }
+                    }
+
+                    // write request to next level
+                    _is_evict_on = true;
+                    issue_to_next(OP_TYPE::STORE, _v_victim_cache.get_tag(0, victim_evict_way) << geom.block_bits());
+                    _is_evict_on = false;
+                }
+                else {
+                    debug<IS_WARM>("Line is not dirty. Invalidating");
+                }
+
+                // invalidate it
+                _v_victim_cache.set_valid(0, victim_evict_way, false);
+                _victim_lru.on_invalidate(0, victim_evict_way);
+            
+                // flag set for replacement
+                _is_repl_on = true;
+                _repl_way = victim_evict_way;
+            }
+            else {
+                // get line to replace in set
+                int evict_way = repl.victim(req_set);
+
+                // put the replaced line to invalid space in victim cache
+                _v_victim_cache.set_tag(0, inv_victim_way, (_v_cache_states.get_tag(req_set, evict_way) << geom.set_bits()) | req_set);
+                _v_victim_cache.set_valid(0, inv_victim_way, true);
+                _v_victim_cache.set_dirty(0, inv_victim_way, _v_cache_states.is_dirty(req_set, evict_way));
+
+                // lru update
+                _victim_lru.on_fill(0, inv_victim_way);
+
+                // invalidate replaced line
+                _v_cache_states.set_valid(req_set, evict_way, false);
+                repl.on_invalidate(req_set, evict_way);
+
+                // get new content here
+                _repl_way = evict_way;
+                _is_repl_on = false;
+            }
+
+            // request from next level
+            fetch_from_next<GEOM, POLICY, IS_WARM>(geom, repl, req);
+        }
+    }
+    else
+    {
+        // No victim cache
+        _repl_way = inv_way;
+
+        if (inv_way == tag_store::NO_WAY)
+        {
+            debug<IS_WARM>("Set is full. Replacement needed!");
+
+            // get line to replace
+            int evict_way = repl.victim(req_set);
+
+            if (_v_cache_states.is_dirty(req_set, evict_way))
+            {
+                debug<IS_WARM>("Line is dirty. Evicting");
+
+                // incrementing writeback counter
+                if constexpr (!IS_WARM) {
+                    hpm_counter_ptr->num_writebacks++;
+                    if (_set_counters != nullptr) {
+                        _set_counters[req_set].writebacks++;
+                    }
+                }
+
+                // write request to next level
+                _is_evict_on = true;
+                issue_to_next(OP_TYPE::STORE, ((_v_cache_states.get_tag(req_set, evict_way) << geom.set_bits()) | req_set) << geom.block_bits());
+                _is_evict_on = false;
+            }
+            else {
+                debug<IS_WARM>("Line is not dirty. Invalidating");
+            }
+
+            // invalidate it
+            _v_cache_states.set_valid(req_set, evict_way, false);
+            repl.on_invalidate(req_set, evict_way);
+            
+            // flag set for replacement
+            _is_repl_on = true;
+            _repl_way = evict_way;
+        }
+        else
+        {
+            _is_repl_on = false;
+        }
+
+        // request from next level
+        fetch_from_next<GEOM, POLICY, IS_WARM>(geom, repl, req);
+    }
+}
+
+template <typename GEOM, typename POLICY, bool IS_WARM>
+void cache::fetch_from_next(const GEOM& geom, POLICY& repl, const mem_req* req)
+{
+    // a level of a static hierarchy reports the fetch in its result instead
+    if (ifc_next != nullptr || _is_level)
+    {
+        // push request to next elvel
+        issue_to_next(OP_TYPE::LOAD, req->addr);
+
+        // per request the next level answers through get_frm_next, a batch or a level fills right away
+        if (_is_batch_on || _is_level) {
+            fill_line<GEOM, POLICY, IS_WARM>(geom, repl, req);
+        }
+    } else {
+        log.log(this, verbose::FATAL, "No next level connection! Check conncections");
+    }
+}
+
+template <typename GEOM, typename POLICY, bool IS_WARM>
+void cache::fill_line(const GEOM& geom, POLICY& repl, const mem_req* req)
+{
+    unsigned resp_set = geom.set_num(req->addr);
+    bool is_store = req -> req_op_type == OP_TYPE::STORE;
+
+    // if replacement flag is set
+    if (_is_repl_on)
+    {
+        if (_repl_way != tag_store::NO_WAY)
+        {
+            // main cache set is full
+            debug<IS_WARM>("Replacing an LRU line");
+
+            if (geom.has_victim_cache())
+            {
+                // get line to replace from main cache
+                int cache_evict_way = repl.victim(resp_set);
+
+                // swap the replaced line in main cache with evicted line
+                // and invalidate the line put in main cache
+
+                // swap lines
+                swap_cache_line(resp_set, cache_evict_way, _repl_way);
+                    
+                // invalidate the line in cache
+                _v_cache_states.set_valid(resp_set, cache_evict_way, false);
+                repl.on_invalidate(resp_set, cache_evict_way);
+
+                // update lru in victim cache
+                _victim_lru.on_fill(0, _repl_way);
+
+                // finally update the replaced line with response
+                _v_cache_states.set_dirty(resp_set, cache_evict_way, is_store);
+                _v_cache_states.set_tag(resp_set, cache_evict_way, geom.cache_tag(req -> addr));
+                _v_cache_states.set_valid(resp_set, cache_evict_way, true);
+                
+                repl.on_fill(resp_set, cache_evict_way);
+
+                _is_evict_on = false;
+            }
+            else
+            {
+                debug<IS_WARM>("Filling evicted line with new content");
+
+                _v_cache_states.set_dirty(resp_set, _repl_way, is_store);
+                _v_cache_states.set_tag(resp_set, _repl_way, geom.cache_tag(req -> addr));
+                _v_cache_states.set_valid(resp_set, _repl_way, true);
+
+                repl.on_fill(resp_set, _repl_way);
+            }
+        }
+        else {
+            assert(false);
+        }
+    }
+    else 
+    {
+        
+        debug<IS_WARM>("Writing response block to set: 0x%x", resp_set);
+
+        // set valid
+        _v_cache_states.set_valid(resp_set, _repl_way, true);
+        
+        // update dirty or non-dirty
+        _v_cache_states.set_dirty(resp_set, _repl_way, is_store);
+        
+        // update tag
+        _v_cache_states.set_tag(resp_set, _repl_way, geom.cache_tag(req->addr));
+
+        // handle miss scenario for replacement
+        repl.on_fill(resp_set, _repl_way);
+    }
+}
+
+template <typename GEOM, typename POLICY>
+const access_result& cache::lookup(const GEOM& geom, POLICY& repl, const mem_req& req)
+{
+    // the next level is never waited for, lines are filled right away and the requests for
+    // the next level are reported in the result, which handle_miss clears
+    _level_result.hit = access(geom, repl, &req);
+
+    return _level_result;
+}
+
+template <typename GEOM, typename POLICY, bool IS_WARM>
+void cache::lookup_batch(const GEOM& geom, POLICY& repl, const mem_req* reqs, size_t num, std::vector<mem_req>& next)
+{
+    for (size_t i = 0; i < num; i++)
+    {
+        if (access<GEOM, POLICY, IS_WARM>(geom, repl, &reqs[i])) {
+            continue;
+        }
+
+        // a writeback always goes out before the fetch
+        if (_level_result.evicted) {
+            next.emplace_back(OP_TYPE::STORE, _level_result.evict_addr);
+        }
+        if (_level_result.filled) {
+            next.emplace_back(OP_TYPE::LOAD, _level_result.fill_addr);
+        }
+    }
+}
+
+#endif // CACHE_ACCESS_H
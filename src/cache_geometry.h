@@ -0,0 +1,141 @@
+/**
+ * @file cache_geometry.h
+ * @details This file contains the geometry descriptions the cache request path is compiled against
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef CACHE_GEOMETRY_H
+#define CACHE_GEOMETRY_H
+
+// standard includes
+#include <tag_store.h>
+
+/**
+ * @details Geometry known only at run time, used for any configuration without a dedicated kernel
+ */
+struct dynamic_geometry
+{
+    unsigned _block_bits;
+    unsigned _set_bits;
+    unsigned _set_mask;
+    bool _has_victim_cache;
+
+    dynamic_geometry() : _block_bits(0), _set_bits(0), _set_mask(0), _has_victim_cache(false) {}
+
+    dynamic_geometry(unsigned block_bits, unsigned set_bits, bool has_victim_cache) :
+        _block_bits(block_bits),
+        _set_bits(set_bits),
+        _set_mask((1u << set_bits) - 1),
+        _has_victim_cache(has_victim_cache)
+    {
+    }
+
+    unsigned block_bits() const {
+        return _block_bits;
+    }
+
+    unsigned set_bits() const {
+        return _set_bits;
+    }
+
+    bool has_victim_cache() const {
+        return _has_victim_cache;
+    }
+
+    unsigned set_num(unsigned addr) const {
+        return (addr >> _block_bits) & _set_mask;
+    }
+
+    unsigned cache_tag(unsigned addr) const {
+        return addr >> (_block_bits + _set_bits);
+    }
+
+    unsigned victim_tag(unsigned addr) const {
+        return addr >> _block_bits;
+    }
+
+    int find(const tag_store& store, unsigned set, unsigned tag) const {
+        return store.find(set, tag);
+    }
+
+    int find_invalid(const tag_store& store, unsigned set) const {
+        return store.find_invalid(set);
+    }
+};
+
+/**
+ * @details Geometry fixed at compile time. Shifts and masks fold into constants and the tag
+ * compare of a set is unrolled for the associativity
+ */
+template <unsigned BLOCKSIZE, unsigned NUM_SETS, unsigned ASSOC, bool HAS_VICTIM_CACHE>
+struct static_geometry
+{
+    static_assert((BLOCKSIZE & (BLOCKSIZE - 1)) == 0 && (NUM_SETS & (NUM_SETS - 1)) == 0, "power of two geometries only");
+    static_assert(ASSOC > 0 && ASSOC <= 64, "one valid mask word per set");
+
+    static constexpr unsigned BLOCK_BITS = __builtin_ctz(BLOCKSIZE);
+    static constexpr unsigned SET_BITS = __builtin_ctz(NUM_SETS);
+
+    unsigned block_bits() const {
+        return BLOCK_BITS;
+    }
+
+    unsigned set_bits() const {
+        return SET_BITS;
+    }
+
+    bool has_victim_cache() const {
+        return HAS_VICTIM_CACHE;
+    }
+
+    unsigned set_num(unsigned addr) const {
+        return (addr >> BLOCK_BITS) & (NUM_SETS - 1);
+    }
+
+    unsigned cache_tag(unsigned addr) const {
+        return addr >> (BLOCK_BITS + SET_BITS);
+    }
+
+    unsigned victim_tag(unsigned addr) const {
+        return addr >> BLOCK_BITS;
+    }
+
+    int find(const tag_store& store, unsigned set, unsigned tag) const {
+        return store.find_fixed<ASSOC>(set, tag);
+    }
+
+    int find_invalid(const tag_store& store, unsigned set) const {
+        return store.find_invalid_fixed<ASSOC>(set);
+    }
+};
+
+/**
+ * @details Geometries with a dedicated LRU kernel, as X(block size, number of sets, associativity)
+ * Each entry is instantiated with and without a victim cache. Add the geometries of a sweep here
+ */
+#define CACHE_KERNEL_GEOMETRIES(X) \
+    X(16, 64, 1)    \
+    X(16, 32, 2)    \
+    X(16, 16, 4)    \
+    X(16, 128, 1)   \
+    X(16, 64, 2)    \
+    X(16, 32, 4)    \
+    X(16, 16, 8)    \
+    X(16, 512, 1)   \
+    X(16, 256, 2)   \
+    X(16, 128, 4)   \
+    X(16, 64, 8)    \
+    X(16, 128, 16)  \
+    X(16, 1024, 4)  \
+    X(16, 512, 8)   \
+    X(32, 32, 1)    \
+    X(32, 16, 2)    \
+    X(32, 64, 4)    \
+    X(32, 256, 4)   \
+    X(32, 128, 8)   \
+    X(64, 64, 4)    \
+    X(64, 64, 8)    \
+    X(64, 512, 8)   \
+    X(64, 1024, 16)
+
+#endif // CACHE_GEOMETRY_H
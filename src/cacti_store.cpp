@@ -0,0 +1,255 @@
+/**
+ * @file cacti_store.cpp
+ * @details This file contains definitions for the persistent CACTI result store
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "cacti_store.h"
+
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <set>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+
+#include <work_pool.h>
+
+// what CACTI prints for an organisation it cannot build, before giving up on it
+static const char* CACTI_REJECTIONS[] = {"no valid", "too small"};
+
+std::vector<cacti_key> cacti_keys(const sim_config& cfg)
+{
+    std::vector<cacti_key> keys;
+
+    keys.emplace_back(cfg.l1_size, cfg.l1_block_size, cfg.l1_assoc);
+
+    // the victim cache is looked up with its number of blocks as block size, as main always has
+    if (cfg.vc_num_blocks != 0) {
+        keys.emplace_back(cfg.vc_num_blocks * cfg.l1_block_size, cfg.vc_num_blocks, cfg.vc_num_blocks);
+    }
+
+    if (cfg.l2_size != 0) {
+        keys.emplace_back(cfg.l2_size, 16, cfg.l2_assoc);
+    }
+
+    return keys;
+}
+
+cacti_store::cacti_store(const std::string& path, CACTI_MODE mode, const cacti_table* table) :
+    base("CACTI store"),
+    _path(path),
+    _mode(table != nullptr ? mode : CACTI_MODE::EXACT),
+    _table(table),
+    _read_pos(0),
+    _num_runs(0)
+{
+}
+
+void cacti_store::read_new()
+{
+    FILE* file = fopen(_path.c_str(), "r");
+    if (file == nullptr) {
+        return;
+    }
+
+    flock(fileno(file), LOCK_SH);
+    fseek(file, _read_pos, SEEK_SET);
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        // lines are appended whole under the lock, anything else is not ours to parse
+        if (strchr(line, '\n') == nullptr) {
+            break;
+        }
+        _read_pos = ftell(file);
+
+        cacti_key key(0, 1, 0);
+        // failures other than rejections may not hold any more, CACTI runs again for them
+        cacti_result res;
+        if (parse_cacti_line(line, key, res) && (res.error == 0 || res.error == CACTI_REJECTED)) {
+            _results.emplace(key, res);
+        }
+    }
+
+    flock(fileno(file), LOCK_UN);
+    fclose(file);
+}
+
+void cacti_store::append(const cacti_key& key, const cacti_result& res)
+{
+    char line[256];
+    int len = format_cacti_line(line, sizeof(line), key, res);
+
+    int fd = open(_path.c_str(), O_WRONLY | O_APPEND | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        std::cout << "WARN: " << _path << ": Unable to write CACTI store" << std::endl;
+        return;
+    }
+
+    flock(fd, LOCK_EX);
+    if (write(fd, line, len) != len) {
+        std::cout << "WARN: " << _path << ": Unable to write CACTI store" << std::endl;
+    }
+    flock(fd, LOCK_UN);
+
+    close(fd);
+}
+
+cacti_result cacti_store::run(const cacti_key& key, bool& is_lasting)
+{
+    cacti_result res;
+    is_lasting = false;
+    _num_runs++;
+
+    // the command and figures of get_cacti_results, with CACTI's exit status and messages kept
+    char command[128];
+    if (key.assoc == 0) {
+        snprintf(command, sizeof(command), "./cacti %u %u FA %s 1 2>&1", key.size, key.blocksize, CACTI_TECH);
+    }
+    else {
+        snprintf(command, sizeof(command), "./cacti %u %u %u %s 1 2>&1", key.size, key.blocksize, key.assoc, CACTI_TECH);
+    }
+
+    FILE* pipe = popen(command, "r");
+    if (pipe == nullptr) {
+        return res;
+    }
+
+    bool is_rejected = false;
+    char buffer[256];
+    while (fgets(buffer, sizeof(buffer), pipe) != nullptr)
+    {
+        const char* value = strchr(buffer, ':');
+        if (strstr(buffer, "Access time") != nullptr && value != nullptr && sscanf(value, ": %f", &res.access_time) == 1) {
+            res.error--;
+        }
+        else if (strstr(buffer, "Total dynamic read energy per access") != nullptr && value != nullptr &&
+                 sscanf(value, ":%f", &res.energy) == 1) {
+            res.error--;
+        }
+        else if (strstr(buffer, "Cache height x width") != nullptr && value != nullptr)
+        {
+            float height, width;
+            if (sscanf(value, ": %f x %f", &height, &width) == 2)
+            {
+                res.area = height * width;
+                res.error--;
+            }
+        }
+        else
+        {
+            for (const char* rejection : CACTI_REJECTIONS) {
+                is_rejected = is_rejected || strstr(buffer, rejection) != nullptr;
+            }
+        }
+    }
+    int status = pclose(pipe);
+
+    // the shell exits with 126 or 127 when CACTI is missing or cannot be run
+    bool is_ran = status != -1 && WIFEXITED(status) && WEXITSTATUS(status) != 126 && WEXITSTATUS(status) != 127;
+    if (res.error == 0) {
+        is_lasting = is_ran && WEXITSTATUS(status) == 0;
+    }
+    else if (is_ran && is_rejected)
+    {
+        res.error = CACTI_REJECTED;
+        is_lasting = true;
+    }
+
+    return res;
+}
+
+const cacti_result* cacti_store::find(const cacti_key& key)
+{
+    auto it = _results.find(key);
+    if (it == _results.end() && !_path.empty())
+    {
+        // another process may have run it meanwhile
+        read_new();
+        it = _results.find(key);
+    }
+
+    return it != _results.end() ? &it->second : nullptr;
+}
+
+bool cacti_store::from_table(const cacti_key& key, cacti_result& res) const
+{
+    switch (_mode)
+    {
+        case CACTI_MODE::TABLE:
+            res = _table->interpolate(key);
+            return true;
+        case CACTI_MODE::FALLBACK:
+            return _table->lookup(key, res);
+        default:
+            return false;
+    }
+}
+
+int cacti_store::get(unsigned size, unsigned blocksize, unsigned assoc, float* access_time, float* energy, float* area)
+{
+    cacti_key key(size, blocksize, assoc);
+    cacti_result res;
+
+    bool is_found = from_table(key, res);
+    if (!is_found)
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        const cacti_result* found = find(key);
+        if (found != nullptr)
+        {
+            res = *found;
+            is_found = true;
+        }
+    }
+
+    // CACTI runs without the lock so prefetch threads overlap
+    if (!is_found)
+    {
+        bool is_lasting;
+        res = run(key, is_lasting);
+
+        // failures of CACTI itself are remembered by this process only
+        std::lock_guard<std::mutex> guard(_lock);
+        if (_results.emplace(key, res).second && is_lasting && !_path.empty()) {
+            append(key, res);
+        }
+    }
+
+    // a failed run may still have filled some of them, main uses those for the victim cache
+    *access_time = res.access_time;
+    *energy = res.energy;
+    *area = res.area;
+
+    return res.error;
+}
+
+void cacti_store::prefetch(const std::vector<cacti_key>& keys, unsigned num_threads)
+{
+    // every organisation once, missing ones only
+    std::set<cacti_key> missing_set;
+    {
+        std::lock_guard<std::mutex> guard(_lock);
+        for (const cacti_key& key : keys)
+        {
+            cacti_result res;
+            if (!from_table(key, res) && find(key) == nullptr) {
+                missing_set.insert(key);
+            }
+        }
+    }
+    std::vector<cacti_key> missing(missing_set.begin(), missing_set.end());
+
+    work_pool pool(num_threads);
+    pool.run(missing.size(), [&](size_t i) {
+        float access_time, energy, area;
+        const cacti_key& key = missing[i];
+        get(key.size, key.blocksize, key.get_ways(), &access_time, &energy, &area);
+    });
+}
@@ -0,0 +1,135 @@
+/**
+ * @file cacti_store.h
+ * @details This file contains a persistent store of CACTI results shared between runs
+ *
+ * The store is a text file of the result lines described in cacti_table.h. Lines are only ever
+ * appended, under an exclusive flock, and read under a shared one, so sweep processes running at the
+ * same time can share a store. A configuration two processes miss at once may be appended twice with
+ * the same result, the first line read wins.
+ *
+ * Only results of CACTI runs that tell something about the organisation are appended: its figures, or
+ * CACTI rejecting it. A CACTI that cannot be started, dies or gives no figures fails for this process
+ * only, and failure lines of older stores, which may be such failures, are not read.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef CACTI_STORE_H
+#define CACTI_STORE_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+
+// local includes
+#include <base.h>
+#include <sweep.h>
+#include <cacti_table.h>
+
+/**
+ * @details Where results come from: always CACTI, only the table model, or the table for its grid
+ * points and CACTI for the rest
+ */
+enum CACTI_MODE {
+    EXACT,
+    TABLE,
+    FALLBACK
+};
+
+/**
+ * @details Get a mode from its command line name, false if the name is unknown
+ */
+inline bool parse_cacti_mode(const std::string& name, CACTI_MODE& mode)
+{
+    if (name == "exact") mode = CACTI_MODE::EXACT;
+    else if (name == "table") mode = CACTI_MODE::TABLE;
+    else if (name == "fallback") mode = CACTI_MODE::FALLBACK;
+    else return false;
+    return true;
+}
+
+/**
+ * @details Organisations main looks up for cfg: L1, the victim cache if any and L2 if any
+ */
+std::vector<cacti_key> cacti_keys(const sim_config& cfg);
+
+/**
+ * @details CACTI results by organisation, kept in memory in front of the store file. CACTI is only
+ * run for organisations neither holds, failures included, so it starts at most once per organisation
+ * for every process sharing the file, and once per process while it cannot run. Depending on the mode a table model answers first
+ */
+class cacti_store : public base
+{
+    private:
+        std::string _path;
+
+        CACTI_MODE _mode;
+        const cacti_table* _table;
+
+        // results read from the file or computed by this process
+        std::map<cacti_key, cacti_result> _results;
+        std::mutex _lock;
+
+        // bytes of the file read so far, lines past it were appended by other processes
+        long _read_pos;
+
+        std::atomic<uint64_t> _num_runs;
+
+        /**
+         * @details Read the lines appended to the file since the last call. Call with _lock held
+         */
+        void read_new();
+
+        /**
+         * @details Append one result to the file
+         */
+        void append(const cacti_key& key, const cacti_result& res);
+
+        /**
+         * @details Run CACTI for key. is_lasting tells whether the result holds for later runs too,
+         * false when CACTI failed for another reason than rejecting the organisation
+         */
+        cacti_result run(const cacti_key& key, bool& is_lasting);
+
+        /**
+         * @details Result for key if this process holds it. Call with _lock held
+         */
+        const cacti_result* find(const cacti_key& key);
+
+        /**
+         * @details Result for key out of the table model, false if CACTI has to be run for it
+         */
+        bool from_table(const cacti_key& key, cacti_result& res) const;
+
+    public:
+
+        /**
+         * @details Store backed by the file at path, an empty path keeps results in memory only. table
+         * is needed for any mode but EXACT
+         */
+        cacti_store(const std::string& path, CACTI_MODE mode = CACTI_MODE::EXACT, const cacti_table* table = nullptr);
+
+        /**
+         * @details Same contract as get_cacti_results: fills the results and returns 0, or returns the
+         * error when CACTI failed on this organisation
+         */
+        int get(unsigned size, unsigned blocksize, unsigned assoc, float* access_time, float* energy, float* area);
+
+        /**
+         * @details Look up every key on num_threads threads, 0 uses one per hardware thread, so the CACTI
+         * runs still missing go on in parallel
+         */
+        void prefetch(const std::vector<cacti_key>& keys, unsigned num_threads);
+
+        /**
+         * @details Number of times this process ran CACTI
+         */
+        uint64_t get_num_runs() const {
+            return _num_runs.load();
+        }
+};
+
+#endif // CACTI_STORE_H
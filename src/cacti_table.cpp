@@ -0,0 +1,280 @@
+/**
+ * @file cacti_table.cpp
+ * @details This file contains definitions for the CACTI result table model
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "cacti_table.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <cacti_table_45nm.h>
+
+bool parse_cacti_line(const char* line, cacti_key& key, cacti_result& res)
+{
+    unsigned size, blocksize;
+    char assoc[16], tech[16];
+    if (sscanf(line, "%u %u %15s %15s %d %f %f %f", &size, &blocksize, assoc, tech, &res.error,
+               &res.access_time, &res.energy, &res.area) != 8 || strcmp(tech, CACTI_TECH) != 0 || blocksize == 0) {
+        return false;
+    }
+
+    unsigned ways = strcmp(assoc, "FA") == 0 ? size / blocksize : std::strtoul(assoc, nullptr, 10);
+    key = cacti_key(size, blocksize, ways);
+
+    return true;
+}
+
+int format_cacti_line(char* buf, size_t len, const cacti_key& key, const cacti_result& res)
+{
+    char assoc[16];
+    if (key.assoc == 0) {
+        strcpy(assoc, "FA");
+    }
+    else {
+        snprintf(assoc, sizeof(assoc), "%u", key.assoc);
+    }
+
+    // enough digits to read back the same float
+    return snprintf(buf, len, "%u %u %s %s %d %.9g %.9g %.9g\n", key.size, key.blocksize, assoc, CACTI_TECH,
+                    res.error, res.access_time, res.energy, res.area);
+}
+
+cacti_table::cacti_table() : base("CACTI table")
+{
+    cacti_key key(0, 1, 0);
+    cacti_result res;
+
+    for (const char* line : CACTI_TABLE_45NM)
+    {
+        if (parse_cacti_line(line, key, res)) {
+            add(key, res);
+        }
+    }
+
+    index();
+}
+
+void cacti_table::add(const cacti_key& key, const cacti_result& res)
+{
+    // the first result of an organisation wins, as in a store
+    _entries.emplace(key, res);
+}
+
+void cacti_table::index()
+{
+    _sizes.clear();
+    _blocksizes.clear();
+    _ways.clear();
+
+    for (const auto& entry : _entries)
+    {
+        if (entry.second.error != 0) {
+            continue;
+        }
+        _sizes.push_back(entry.first.size);
+        _blocksizes.push_back(entry.first.blocksize);
+        _ways.push_back(entry.first.get_ways());
+    }
+
+    for (std::vector<unsigned>* axis : {&_sizes, &_blocksizes, &_ways})
+    {
+        std::sort(axis->begin(), axis->end());
+        axis->erase(std::unique(axis->begin(), axis->end()), axis->end());
+    }
+}
+
+bool cacti_table::load(const std::string& path)
+{
+    FILE* file = fopen(path.c_str(), "r");
+    if (file == nullptr) {
+        return false;
+    }
+
+    std::map<cacti_key, cacti_result> entries;
+    cacti_key key(0, 1, 0);
+    cacti_result res;
+
+    char line[256];
+    while (fgets(line, sizeof(line), file) != nullptr)
+    {
+        if (parse_cacti_line(line, key, res)) {
+            entries.emplace(key, res);
+        }
+    }
+    fclose(file);
+
+    if (entries.empty()) {
+        return false;
+    }
+
+    _entries.swap(entries);
+    index();
+
+    return true;
+}
+
+bool cacti_table::lookup(const cacti_key& key, cacti_result& res) const
+{
+    auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return false;
+    }
+
+    res = it->second;
+    return true;
+}
+
+/**
+ * @details Grid points around x along one axis and the weight of the upper one
+ */
+struct axis_pos
+{
+    unsigned lo;
+    unsigned hi;
+    double hi_weight;
+};
+
+/**
+ * @details Where x sits along axis. With reach 0 a grid point stands alone, otherwise the reach-th
+ * points below and above x are taken, x itself left out. A side the axis ends before is left out, and
+ * with both out x stands alone
+ */
+static axis_pos locate(const std::vector<unsigned>& axis, unsigned x, unsigned reach)
+{
+    auto lo_it = std::lower_bound(axis.begin(), axis.end(), x);
+    auto hi_it = lo_it;
+
+    if (lo_it != axis.end() && *lo_it == x)
+    {
+        if (reach == 0) {
+            return {x, x, 0.0};
+        }
+        hi_it++;
+    }
+
+    // off the grid the nearest points are the first ones out
+    reach = std::max(reach, 1u);
+
+    bool has_lo = (size_t) (lo_it - axis.begin()) >= reach;
+    bool has_hi = (size_t) (axis.end() - hi_it) >= reach;
+
+    if (!has_lo && !has_hi) {
+        return {x, x, 0.0};
+    }
+    if (!has_lo) {
+        return {hi_it[reach - 1], hi_it[reach - 1], 0.0};
+    }
+    if (!has_hi) {
+        return {lo_it[-(long) reach], lo_it[-(long) reach], 0.0};
+    }
+
+    unsigned lo = lo_it[-(long) reach];
+    unsigned hi = hi_it[reach - 1];
+    return {lo, hi, (std::log2(x) - std::log2(lo)) / (std::log2(hi) - std::log2(lo))};
+}
+
+bool cacti_table::blend(const axis_pos pos[3], cacti_result& res) const
+{
+    // weighted geometric mean over the corners CACTI could model, as area and energy grow about
+    // proportionally to size
+    double sum_weight = 0.0;
+    double access_time = 0.0;
+    double energy = 0.0;
+    double area = 0.0;
+
+    for (unsigned corner = 0; corner < 8; corner++)
+    {
+        unsigned point[3];
+        double weight = 1.0;
+        for (unsigned axis = 0; axis < 3; axis++)
+        {
+            bool is_hi = (corner >> axis) & 1;
+            point[axis] = is_hi ? pos[axis].hi : pos[axis].lo;
+            weight *= is_hi ? pos[axis].hi_weight : 1.0 - pos[axis].hi_weight;
+        }
+
+        cacti_result corner_res;
+        if (weight == 0.0 || !lookup(cacti_key(point[0], point[1], point[2]), corner_res) || corner_res.error != 0 ||
+            corner_res.access_time <= 0.0f || corner_res.energy <= 0.0f || corner_res.area <= 0.0f) {
+            continue;
+        }
+
+        sum_weight += weight;
+        access_time += weight * std::log(corner_res.access_time);
+        energy += weight * std::log(corner_res.energy);
+        area += weight * std::log(corner_res.area);
+    }
+
+    if (sum_weight == 0.0) {
+        return false;
+    }
+
+    res.error = 0;
+    res.access_time = std::exp(access_time / sum_weight);
+    res.energy = std::exp(energy / sum_weight);
+    res.area = std::exp(area / sum_weight);
+
+    return true;
+}
+
+cacti_result cacti_table::interpolate(const cacti_key& key) const
+{
+    cacti_result res;
+    if ((lookup(key, res) && res.error == 0) || _sizes.empty()) {
+        return res;
+    }
+
+    unsigned ways = key.get_ways();
+    axis_pos pos[3] = {
+        locate(_sizes, key.size, 0),
+        locate(_blocksizes, key.blocksize, 0),
+        locate(_ways, ways, 0)
+    };
+
+    if (blend(pos, res)) {
+        return res;
+    }
+
+    // nothing around it could be modelled, widen outward one grid point at a time, first in
+    // associativity alone, then along every axis, until some corner was modelled
+    size_t max_reach = std::max({_sizes.size(), _blocksizes.size(), _ways.size()});
+    for (unsigned reach = 1; reach <= max_reach; reach++)
+    {
+        pos[0] = locate(_sizes, key.size, 0);
+        pos[1] = locate(_blocksizes, key.blocksize, 0);
+        pos[2] = locate(_ways, ways, reach);
+        if (blend(pos, res)) {
+            return res;
+        }
+
+        pos[0] = locate(_sizes, key.size, reach);
+        pos[1] = locate(_blocksizes, key.blocksize, reach);
+        if (blend(pos, res)) {
+            return res;
+        }
+    }
+
+    // the corners skip the points off the cell diagonals, take the closest successful one
+    double best_dist = INFINITY;
+    for (const auto& entry : _entries)
+    {
+        if (entry.second.error != 0) {
+            continue;
+        }
+        double dist = std::pow(std::log2(entry.first.size) - std::log2(key.size), 2) +
+                      std::pow(std::log2(entry.first.blocksize) - std::log2(key.blocksize), 2) +
+                      std::pow(std::log2(entry.first.get_ways()) - std::log2(ways), 2);
+        if (dist < best_dist)
+        {
+            best_dist = dist;
+            res = entry.second;
+        }
+    }
+
+    return res;
+}
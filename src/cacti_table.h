@@ -0,0 +1,156 @@
+/**
+ * @file cacti_table.h
+ * @details This file contains CACTI results by cache organisation and a table model interpolating them
+ *
+ * Results are written one per line, in cacti_store files and table files alike:
+ *
+ *      <size> <block size> <associativity or FA> <technology> <error> <access time> <energy> <area>
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef CACTI_TABLE_H
+#define CACTI_TABLE_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <map>
+#include <cstddef>
+
+// local includes
+#include <base.h>
+
+struct axis_pos;
+
+/**
+ * @details Technology node CACTI is run for
+ */
+const char CACTI_TECH[] = "45nm";
+
+/**
+ * @details Cache organisation CACTI is run for
+ */
+struct cacti_key
+{
+    unsigned size;
+    unsigned blocksize;
+
+    // 0 for a fully associative cache
+    unsigned assoc;
+
+    cacti_key(unsigned size, unsigned blocksize, unsigned assoc) :
+        size(size), blocksize(blocksize), assoc(assoc == size / blocksize ? 0 : assoc)
+    {
+    }
+
+    /**
+     * @details Number of ways, the number of blocks when fully associative
+     */
+    unsigned get_ways() const {
+        return assoc == 0 ? size / blocksize : assoc;
+    }
+
+    bool operator<(const cacti_key& other) const
+    {
+        if (size != other.size) {
+            return size < other.size;
+        }
+        if (blocksize != other.blocksize) {
+            return blocksize < other.blocksize;
+        }
+        return assoc < other.assoc;
+    }
+};
+
+/**
+ * @details Error of an organisation CACTI ran on and rejected, as stores write it. Other failures
+ * are the number of results CACTI did not give, as get_cacti_results returns
+ */
+const int CACTI_REJECTED = 4;
+
+/**
+ * @details CACTI output for one organisation, error is the value get_cacti_results returned
+ */
+struct cacti_result
+{
+    int error;
+    float access_time;
+    float energy;
+    float area;
+
+    cacti_result() : error(3), access_time(0.0f), energy(0.0f), area(0.0f) {}
+};
+
+/**
+ * @details Read one result line, false if it is malformed or for another technology
+ */
+bool parse_cacti_line(const char* line, cacti_key& key, cacti_result& res);
+
+/**
+ * @details Write one result line into buf, newline included, and return its length
+ */
+int format_cacti_line(char* buf, size_t len, const cacti_key& key, const cacti_result& res);
+
+/**
+ * @details CACTI results over a grid of organisations. Organisations between grid points get the log
+ * of access time, energy and area interpolated linearly in the log2 of size, block size and associativity
+ */
+class cacti_table : public base
+{
+    private:
+        std::map<cacti_key, cacti_result> _entries;
+
+        // grid points of the successful entries along each axis, sorted
+        std::vector<unsigned> _sizes;
+        std::vector<unsigned> _blocksizes;
+        std::vector<unsigned> _ways;
+
+        /**
+         * @details Add one entry, call index() once all are in
+         */
+        void add(const cacti_key& key, const cacti_result& res);
+
+        /**
+         * @details Rebuild the grid points out of the entries
+         */
+        void index();
+
+        /**
+         * @details Weighted geometric mean of the successful corners of the cell pos spans, false if there
+         * are none
+         */
+        bool blend(const axis_pos pos[3], cacti_result& res) const;
+
+    public:
+
+        /**
+         * @details Table of the built-in CACTI 45nm results
+         */
+        cacti_table();
+
+        /**
+         * @details Replace the entries by the result lines of the file at path, false if it cannot
+         * be read or holds no results
+         */
+        bool load(const std::string& path);
+
+        /**
+         * @details Result of an organisation in the table, false if it is not a grid point
+         */
+        bool lookup(const cacti_key& key, cacti_result& res) const;
+
+        /**
+         * @details Result of any organisation: a successful grid point as it is, otherwise interpolated
+         * between the successful grid points around it. Outside the grid the nearest edge is used. When
+         * none around it succeeded, as for organisations CACTI fails on, the search widens one grid point
+         * further out at a time, in associativity first, then along every axis, and past the whole grid the
+         * closest successful grid point is used. The result keeps its error only if the table has none
+         */
+        cacti_result interpolate(const cacti_key& key) const;
+
+        size_t get_num_entries() const {
+            return _entries.size();
+        }
+};
+
+#endif // CACTI_TABLE_H
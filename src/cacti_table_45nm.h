@@ -0,0 +1,421 @@
+/**
+ * @file cacti_table_45nm.h
+ * @details This file contains the built-in table of CACTI 45nm results, as cacti_table result lines. It was
+ * generated with the CACTI shipped with the assignment by prefetching a sweep grid into an empty store:
+ *
+ *      ./cache_sim --sweep <grid> <trace> --cacti=exact --cacti-prefetch --cacti-store=<file>
+ *
+ * over the grid
+ *
+ *      l1_size 64 128 256 512 1024 2048 4096 8192 16384 32768 65536 131072 262144 524288 1048576
+ *      l1_assoc 1 2 4 8 16 32
+ *      l1_block 8 16 32 64 128
+ *      vc_blocks 0
+ *      l2_size 0
+ *
+ * Organisations CACTI fails on are kept with their error, as in a store
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef CACTI_TABLE_45NM_H
+#define CACTI_TABLE_45NM_H
+
+static const char* const CACTI_TABLE_45NM[] = {
+    "64 8 1 45nm 3 0 0 0",
+    "64 8 2 45nm 3 0 0 0",
+    "64 8 4 45nm 3 0 0 0",
+    "64 8 FA 45nm 0 0.133175999 0.0031711699 0.000406866049",
+    "64 16 1 45nm 3 0 0 0",
+    "64 16 2 45nm 3 0 0 0",
+    "64 16 FA 45nm 0 0.130418003 0.00288489996 0.000406866049",
+    "64 32 1 45nm 3 0 0 0",
+    "64 32 FA 45nm 3 0 0 0",
+    "64 64 FA 45nm 3 0 0 0",
+    "128 8 1 45nm 3 0 0 0",
+    "128 8 2 45nm 3 0 0 0",
+    "128 8 4 45nm 3 0 0 0",
+    "128 8 8 45nm 3 0 0 0",
+    "128 8 FA 45nm 0 0.139107004 0.00378241995 0.000695497787",
+    "128 16 1 45nm 3 0 0 0",
+    "128 16 2 45nm 3 0 0 0",
+    "128 16 4 45nm 3 0 0 0",
+    "128 16 FA 45nm 0 0.133975998 0.00321367988 0.000695497787",
+    "128 32 1 45nm 3 0 0 0",
+    "128 32 2 45nm 3 0 0 0",
+    "128 32 FA 45nm 0 0.131218001 0.00292740995 0.000695497787",
+    "128 64 1 45nm 3 0 0 0",
+    "128 64 FA 45nm 3 0 0 0",
+    "128 128 FA 45nm 3 0 0 0",
+    "256 8 1 45nm 0 0.124743 0.000809665013 0.00322024641",
+    "256 8 2 45nm 3 0 0 0",
+    "256 8 4 45nm 3 0 0 0",
+    "256 8 8 45nm 3 0 0 0",
+    "256 8 16 45nm 3 0 0 0",
+    "256 8 FA 45nm 0 0.150218993 0.00494995993 0.00132046349",
+    "256 16 1 45nm 3 0 0 0",
+    "256 16 2 45nm 3 0 0 0",
+    "256 16 4 45nm 3 0 0 0",
+    "256 16 8 45nm 3 0 0 0",
+    "256 16 FA 45nm 0 0.140732005 0.00381877995 0.00132046349",
+    "256 32 1 45nm 3 0 0 0",
+    "256 32 2 45nm 3 0 0 0",
+    "256 32 4 45nm 3 0 0 0",
+    "256 32 FA 45nm 0 0.135600999 0.00325004011 0.00132046349",
+    "256 64 1 45nm 3 0 0 0",
+    "256 64 2 45nm 3 0 0 0",
+    "256 64 FA 45nm 0 0.132843003 0.00296376995 0.00132046349",
+    "256 128 1 45nm 3 0 0 0",
+    "256 128 FA 45nm 3 0 0 0",
+    "512 8 1 45nm 0 0.127943993 0.000980300014 0.00476068864",
+    "512 8 2 45nm 0 0.169666007 0.00178785995 0.00777197909",
+    "512 8 4 45nm 3 0 0 0",
+    "512 8 8 45nm 3 0 0 0",
+    "512 8 16 45nm 3 0 0 0",
+    "512 8 32 45nm 3 0 0 0",
+    "512 16 1 45nm 0 0.124743 0.000898887985 0.00447864598",
+    "512 16 2 45nm 3 0 0 0",
+    "512 16 4 45nm 3 0 0 0",
+    "512 16 8 45nm 3 0 0 0",
+    "512 16 16 45nm 3 0 0 0",
+    "512 16 FA 45nm 0 0.151884004 0.00503918016 0.00248541194",
+    "512 32 1 45nm 3 0 0 0",
+    "512 32 2 45nm 3 0 0 0",
+    "512 32 4 45nm 3 0 0 0",
+    "512 32 8 45nm 3 0 0 0",
+    "512 32 FA 45nm 0 0.142397001 0.0039080102 0.00248541194",
+    "512 64 1 45nm 3 0 0 0",
+    "512 64 2 45nm 3 0 0 0",
+    "512 64 4 45nm 3 0 0 0",
+    "512 64 FA 45nm 0 0.137265995 0.0033392699 0.00248541194",
+    "512 128 1 45nm 3 0 0 0",
+    "512 128 2 45nm 3 0 0 0",
+    "512 128 FA 45nm 0 0.134507999 0.00305298995 0.00248541194",
+    "1024 8 1 45nm 0 0.143791005 0.00122715998 0.00893818121",
+    "1024 8 2 45nm 0 0.178167 0.00204167003 0.00960043538",
+    "1024 8 4 45nm 0 0.186039001 0.00468717003 0.0153468028",
+    "1024 8 8 45nm 3 0 0 0",
+    "1024 8 16 45nm 3 0 0 0",
+    "1024 8 32 45nm 3 0 0 0",
+    "1024 16 1 45nm 0 0.128841996 0.00108791003 0.00960782077",
+    "1024 16 2 45nm 0 0.174772993 0.00188629003 0.00960043538",
+    "1024 16 4 45nm 3 0 0 0",
+    "1024 16 8 45nm 3 0 0 0",
+    "1024 16 16 45nm 3 0 0 0",
+    "1024 16 32 45nm 3 0 0 0",
+    "1024 32 1 45nm 0 0.130337998 0.000989243039 0.00925501063",
+    "1024 32 2 45nm 3 0 0 0",
+    "1024 32 4 45nm 3 0 0 0",
+    "1024 32 8 45nm 3 0 0 0",
+    "1024 32 16 45nm 3 0 0 0",
+    "1024 32 FA 45nm 0 0.155077994 0.00513903983 0.00393696735",
+    "1024 64 1 45nm 3 0 0 0",
+    "1024 64 2 45nm 3 0 0 0",
+    "1024 64 4 45nm 3 0 0 0",
+    "1024 64 8 45nm 3 0 0 0",
+    "1024 64 FA 45nm 0 0.145591006 0.00400786987 0.00393696735",
+    "1024 128 1 45nm 3 0 0 0",
+    "1024 128 2 45nm 3 0 0 0",
+    "1024 128 4 45nm 3 0 0 0",
+    "1024 128 FA 45nm 0 0.142358005 0.00343913003 0.00393696735",
+    "2048 8 1 45nm 0 0.151631996 0.00156223995 0.0190158356",
+    "2048 8 2 45nm 0 0.201121002 0.00270257005 0.0209888835",
+    "2048 8 4 45nm 0 0.202456996 0.00508631999 0.0256924201",
+    "2048 8 8 45nm 0 0.225078002 0.0142304003 0.0353056863",
+    "2048 8 16 45nm 3 0 0 0",
+    "2048 8 32 45nm 3 0 0 0",
+    "2048 16 1 45nm 0 0.145207003 0.00131246005 0.0168436226",
+    "2048 16 2 45nm 0 0.185368001 0.00221016002 0.0202670284",
+    "2048 16 4 45nm 0 0.198677003 0.00475944998 0.0256924201",
+    "2048 16 8 45nm 3 0 0 0",
+    "2048 16 16 45nm 3 0 0 0",
+    "2048 16 32 45nm 3 0 0 0",
+    "2048 32 1 45nm 0 0.145207003 0.00117043999 0.0142555321",
+    "2048 32 2 45nm 0 0.181973994 0.00205479003 0.0202670284",
+    "2048 32 4 45nm 3 0 0 0",
+    "2048 32 8 45nm 3 0 0 0",
+    "2048 32 16 45nm 3 0 0 0",
+    "2048 32 32 45nm 3 0 0 0",
+    "2048 64 1 45nm 0 0.145207003 0.00110046996 0.0142555321",
+    "2048 64 2 45nm 3 0 0 0",
+    "2048 64 4 45nm 3 0 0 0",
+    "2048 64 8 45nm 3 0 0 0",
+    "2048 64 16 45nm 3 0 0 0",
+    "2048 64 FA 45nm 0 0.158812001 0.00532370992 0.0077095055",
+    "2048 128 1 45nm 3 0 0 0",
+    "2048 128 2 45nm 3 0 0 0",
+    "2048 128 4 45nm 3 0 0 0",
+    "2048 128 8 45nm 3 0 0 0",
+    "2048 128 FA 45nm 0 0.151070997 0.0041894 0.0107479654",
+    "4096 8 1 45nm 0 0.168674007 0.0020735201 0.0496028177",
+    "4096 8 2 45nm 0 0.217374995 0.00329222996 0.035226386",
+    "4096 8 4 45nm 0 0.225627005 0.00615483988 0.0381584167",
+    "4096 8 8 45nm 0 0.227813005 0.0158788003 0.052140329",
+    "4096 8 16 45nm 0 0.285425991 0.0506516993 0.13158071",
+    "4096 8 32 45nm 3 0 0 0",
+    "4096 16 1 45nm 0 0.163664997 0.00168699003 0.0352153145",
+    "4096 16 2 45nm 0 0.202306002 0.00272085005 0.0344074778",
+    "4096 16 4 45nm 0 0.210696995 0.00528289005 0.0382728092",
+    "4096 16 8 45nm 0 0.231153995 0.0145835998 0.0509045944",
+    "4096 16 16 45nm 3 0 0 0",
+    "4096 16 32 45nm 3 0 0 0",
+    "4096 32 1 45nm 0 0.163616002 0.00152639998 0.0351691768",
+    "4096 32 2 45nm 0 0.189586997 0.00221586996 0.0266659651",
+    "4096 32 4 45nm 0 0.206917003 0.00495602004 0.0382728092",
+    "4096 32 8 45nm 3 0 0 0",
+    "4096 32 16 45nm 3 0 0 0",
+    "4096 32 32 45nm 3 0 0 0",
+    "4096 64 1 45nm 0 0.163616002 0.00138439005 0.0300582387",
+    "4096 64 2 45nm 0 0.186232001 0.0020759101 0.0266659651",
+    "4096 64 4 45nm 3 0 0 0",
+    "4096 64 8 45nm 3 0 0 0",
+    "4096 64 16 45nm 3 0 0 0",
+    "4096 64 32 45nm 3 0 0 0",
+    "4096 128 1 45nm 0 0.163616002 0.00131441001 0.0300582387",
+    "4096 128 2 45nm 3 0 0 0",
+    "4096 128 4 45nm 3 0 0 0",
+    "4096 128 8 45nm 3 0 0 0",
+    "4096 128 16 45nm 3 0 0 0",
+    "4096 128 FA 45nm 0 0.169762 0.00553451991 0.0231315233",
+    "8192 8 1 45nm 0 0.188124999 0.00290527008 0.0743338391",
+    "8192 8 2 45nm 0 0.245359004 0.00465297978 0.0721040294",
+    "8192 8 4 45nm 0 0.252481014 0.00748624001 0.0651227683",
+    "8192 8 8 45nm 0 0.270796001 0.0170313995 0.102446839",
+    "8192 8 16 45nm 0 0.295718014 0.0527368002 0.154236972",
+    "8192 8 32 45nm 0 0.40369001 0.190923005 0.507630229",
+    "8192 16 1 45nm 0 0.183551997 0.00253456994 0.0655208454",
+    "8192 16 2 45nm 0 0.226117 0.00375345 0.0706750378",
+    "8192 16 4 45nm 0 0.231417999 0.00594562991 0.0629903153",
+    "8192 16 8 45nm 0 0.239205003 0.0164014008 0.104757801",
+    "8192 16 16 45nm 0 0.291166008 0.0512086004 0.131490052",
+    "8192 16 32 45nm 3 0 0 0",
+    "8192 32 1 45nm 0 0.183551997 0.00222545001 0.0551038571",
+    "8192 32 2 45nm 0 0.212550998 0.00307575008 0.0594411567",
+    "8192 32 4 45nm 0 0.216571003 0.0049987901 0.0624328628",
+    "8192 32 8 45nm 0 0.242546007 0.0151062002 0.102333859",
+    "8192 32 16 45nm 3 0 0 0",
+    "8192 32 32 45nm 3 0 0 0",
+    "8192 64 1 45nm 0 0.183551997 0.00206486997 0.0550566725",
+    "8192 64 2 45nm 0 0.202575997 0.00254775002 0.0557221584",
+    "8192 64 4 45nm 0 0.212868005 0.00470873015 0.0624328628",
+    "8192 64 8 45nm 3 0 0 0",
+    "8192 64 16 45nm 3 0 0 0",
+    "8192 64 32 45nm 3 0 0 0",
+    "8192 128 1 45nm 0 0.183551997 0.00192285003 0.0497942269",
+    "8192 128 2 45nm 0 0.199221 0.00240778993 0.0557221584",
+    "8192 128 4 45nm 3 0 0 0",
+    "8192 128 8 45nm 3 0 0 0",
+    "8192 128 16 45nm 3 0 0 0",
+    "8192 128 32 45nm 3 0 0 0",
+    "16384 8 1 45nm 0 0.214188993 0.0042972099 0.153821185",
+    "16384 8 2 45nm 0 0.27631399 0.00681066979 0.137467399",
+    "16384 8 4 45nm 0 0.285016 0.0102316001 0.116747662",
+    "16384 8 8 45nm 0 0.302570999 0.0173317995 0.120845586",
+    "16384 8 16 45nm 0 0.330240995 0.056057401 0.203334033",
+    "16384 8 32 45nm 0 0.414296001 0.194786996 0.552619517",
+    "16384 16 1 45nm 0 0.210644007 0.00340125011 0.124883868",
+    "16384 16 2 45nm 0 0.254925996 0.00550610013 0.0986041725",
+    "16384 16 4 45nm 0 0.261810988 0.00837047026 0.0899269208",
+    "16384 16 8 45nm 0 0.275361001 0.0153281 0.120871887",
+    "16384 16 16 45nm 0 0.306475997 0.0535660982 0.203103647",
+    "16384 16 32 45nm 0 0.409743994 0.191731006 0.507389784",
+    "16384 32 1 45nm 0 0.210644007 0.00304748002 0.105663098",
+    "16384 32 2 45nm 0 0.233679995 0.00465726014 0.117822222",
+    "16384 32 4 45nm 0 0.243285 0.00658854982 0.0877576768",
+    "16384 32 8 45nm 0 0.251776993 0.0142778996 0.120761015",
+    "16384 32 16 45nm 0 0.301925004 0.0520378985 0.203103647",
+    "16384 32 32 45nm 3 0 0 0",
+    "16384 64 1 45nm 0 0.210644007 0.00273933006 0.105688684",
+    "16384 64 2 45nm 0 0.226521 0.0038610599 0.0732422471",
+    "16384 64 4 45nm 0 0.223143995 0.00594490021 0.103219613",
+    "16384 64 8 45nm 0 0.247380003 0.0136112999 0.120761015",
+    "16384 64 16 45nm 3 0 0 0",
+    "16384 64 32 45nm 3 0 0 0",
+    "16384 128 1 45nm 0 0.210644007 0.00257874001 0.105600879",
+    "16384 128 2 45nm 0 0.224897996 0.00298420992 0.0877833441",
+    "16384 128 4 45nm 0 0.219441995 0.0056548398 0.103219613",
+    "16384 128 8 45nm 3 0 0 0",
+    "16384 128 16 45nm 3 0 0 0",
+    "16384 128 32 45nm 3 0 0 0",
+    "32768 8 1 45nm 0 0.245647997 0.0055776299 0.257607013",
+    "32768 8 2 45nm 0 0.323763013 0.00962502044 0.208312213",
+    "32768 8 4 45nm 0 0.337783009 0.0126181003 0.231940612",
+    "32768 8 8 45nm 0 0.345881999 0.0222447999 0.242423937",
+    "32768 8 16 45nm 0 0.363821 0.0529491007 0.346170127",
+    "32768 8 32 45nm 0 0.450046986 0.201544002 0.599004567",
+    "32768 16 1 45nm 0 0.245432004 0.00495353993 0.212602168",
+    "32768 16 2 45nm 0 0.293962002 0.00803489983 0.277702153",
+    "32768 16 4 45nm 0 0.304713011 0.0114010004 0.214856386",
+    "32768 16 8 45nm 0 0.319604009 0.0187743995 0.24201183",
+    "32768 16 16 45nm 0 0.336614996 0.0488202013 0.346266657",
+    "32768 16 32 45nm 0 0.426160008 0.195895001 0.556125939",
+    "32768 32 1 45nm 0 0.245432004 0.00445188023 0.212667599",
+    "32768 32 2 45nm 0 0.275148004 0.00649789022 0.200636864",
+    "32768 32 4 45nm 0 0.281551987 0.00938639976 0.183216885",
+    "32768 32 8 45nm 0 0.288352013 0.0169670004 0.246994734",
+    "32768 32 16 45nm 0 0.312967002 0.0465678014 0.345858216",
+    "32768 32 32 45nm 0 0.421608001 0.192837998 0.510609269",
+    "32768 64 1 45nm 0 0.245432004 0.00413409993 0.204891384",
+    "32768 64 2 45nm 0 0.259934008 0.00553440023 0.158468187",
+    "32768 64 4 45nm 0 0.264578015 0.00747948 0.178917289",
+    "32768 64 8 45nm 0 0.272891998 0.0153023005 0.241845861",
+    "32768 64 16 45nm 0 0.308569998 0.0452345982 0.345858216",
+    "32768 64 32 45nm 3 0 0 0",
+    "32768 128 1 45nm 0 0.245432004 0.00387515989 0.186517581",
+    "32768 128 2 45nm 0 0.256866008 0.00490655005 0.159957081",
+    "32768 128 4 45nm 0 0.254601002 0.00695582014 0.210440338",
+    "32768 128 8 45nm 0 0.268494993 0.0146356998 0.241845861",
+    "32768 128 16 45nm 3 0 0 0",
+    "32768 128 32 45nm 3 0 0 0",
+    "65536 8 1 45nm 0 0.298945993 0.00748470007 0.397446781",
+    "65536 8 2 45nm 0 0.365382999 0.0135955 0.431538999",
+    "65536 8 4 45nm 0 0.386839002 0.0195570998 0.451994419",
+    "65536 8 8 45nm 0 0.394169003 0.0321138017 0.455052912",
+    "65536 8 16 45nm 0 0.405974001 0.0626484007 0.483143747",
+    "65536 8 32 45nm 0 0.475425005 0.178212002 0.698188066",
+    "65536 16 1 45nm 0 0.298945993 0.00652241008 0.385450602",
+    "65536 16 2 45nm 0 0.333427995 0.0108201997 0.334672928",
+    "65536 16 4 45nm 0 0.357811987 0.0139562003 0.33777687",
+    "65536 16 8 45nm 0 0.365301996 0.0236610007 0.343008727",
+    "65536 16 16 45nm 0 0.383664995 0.0546962991 0.482297391",
+    "65536 16 32 45nm 0 0.450533003 0.169211999 0.769754827",
+    "65536 32 1 45nm 0 0.298945993 0.00590626011 0.328073621",
+    "65536 32 2 45nm 0 0.311915994 0.00845998991 0.380536079",
+    "65536 32 4 45nm 0 0.321240008 0.0129658999 0.342357934",
+    "65536 32 8 45nm 0 0.333817005 0.0205467995 0.347501099",
+    "65536 32 16 45nm 0 0.356458008 0.0505673997 0.482404232",
+    "65536 32 32 45nm 0 0.424468994 0.164373994 0.697551429",
+    "65536 64 1 45nm 0 0.298945993 0.00540459994 0.328174561",
+    "65536 64 2 45nm 0 0.30360499 0.00729423016 0.356464624",
+    "65536 64 4 45nm 0 0.305669993 0.0103582004 0.287468463",
+    "65536 64 8 45nm 0 0.307772011 0.0183831993 0.34765774",
+    "65536 64 16 45nm 0 0.332810998 0.0483149998 0.481955796",
+    "65536 64 32 45nm 0 0.420071006 0.161706999 0.697551429",
+    "65536 128 1 45nm 0 0.298945993 0.00508682011 0.316178381",
+    "65536 128 2 45nm 0 0.302073985 0.00609119982 0.307809502",
+    "65536 128 4 45nm 0 0.299344003 0.00870375987 0.337817311",
+    "65536 128 8 45nm 0 0.298352987 0.0166184008 0.401560038",
+    "65536 128 16 45nm 0 0.328413993 0.0469818003 0.481955796",
+    "65536 128 32 45nm 3 0 0 0",
+    "131072 8 1 45nm 0 0.365256011 0.0112025999 0.806053281",
+    "131072 8 2 45nm 0 0.445612013 0.0179811995 0.797099829",
+    "131072 8 4 45nm 0 0.459540009 0.0244472995 0.94161737",
+    "131072 8 8 45nm 0 0.487298012 0.0457211994 0.917755008",
+    "131072 8 16 45nm 0 0.500402987 0.083767198 0.884289145",
+    "131072 8 32 45nm 0 0.529034019 0.200278997 1.39594293",
+    "131072 16 1 45nm 0 0.365256011 0.00982480962 0.61691612",
+    "131072 16 2 45nm 0 0.394297987 0.0165190995 0.867691815",
+    "131072 16 4 45nm 0 0.41108799 0.0200280007 0.859785199",
+    "131072 16 8 45nm 0 0.430532992 0.034633901 0.835286856",
+    "131072 16 16 45nm 0 0.439936012 0.0660051033 0.882134318",
+    "131072 16 32 45nm 0 0.506510019 0.183684006 1.39282286",
+    "131072 32 1 45nm 0 0.365256011 0.00886251964 0.598214269",
+    "131072 32 2 45nm 0 0.370191008 0.0128279999 0.675774336",
+    "131072 32 4 45nm 0 0.378803998 0.0158968009 0.600597441",
+    "131072 32 8 45nm 0 0.398474991 0.0266033001 0.692649782",
+    "131072 32 16 45nm 0 0.417627007 0.0580530018 0.880591154",
+    "131072 32 32 45nm 0 0.47931999 0.174950004 1.3932153",
+    "131072 64 1 45nm 0 0.365256011 0.0082463799 0.508764684",
+    "131072 64 2 45nm 0 0.365341991 0.0101643996 0.625485003",
+    "131072 64 4 45nm 0 0.367715001 0.0131256003 0.509660542",
+    "131072 64 8 45nm 0 0.373535007 0.0228448007 0.644917846",
+    "131072 64 16 45nm 0 0.390421003 0.0539240986 0.880784631",
+    "131072 64 32 45nm 0 0.455554008 0.169845998 1.3915627",
+    "131072 128 1 45nm 0 0.365256011 0.00774470996 0.508921981",
+    "131072 128 2 45nm 0 0.365341991 0.00890315045 0.49503085",
+    "131072 128 4 45nm 0 0.365422994 0.0111967996 0.504465044",
+    "131072 128 8 45nm 0 0.364948988 0.0200667009 0.635988891",
+    "131072 128 16 45nm 0 0.366773009 0.0516716987 0.87996769",
+    "131072 128 32 45nm 0 0.451157004 0.167180002 1.3915627",
+    "262144 8 1 45nm 0 0.442865014 0.0156568997 1.31766081",
+    "262144 8 2 45nm 0 0.535016 0.0284266993 1.60468388",
+    "262144 8 4 45nm 0 0.545011997 0.0380650014 1.62199342",
+    "262144 8 8 45nm 0 0.558723986 0.0613876991 1.67337596",
+    "262144 8 16 45nm 0 0.609700978 0.117490001 1.87637711",
+    "262144 8 32 45nm 0 0.637831986 0.233339995 1.78640962",
+    "262144 16 1 45nm 0 0.442865014 0.0137334997 1.27258027",
+    "262144 16 2 45nm 0 0.481693 0.0218548998 1.29115152",
+    "262144 16 4 45nm 0 0.496392995 0.0271607004 1.2515111",
+    "262144 16 8 45nm 0 0.50524199 0.046552401 1.45984662",
+    "262144 16 16 45nm 0 0.536638975 0.0919279978 1.26122141",
+    "262144 16 32 45nm 0 0.569422007 0.201355994 1.78197849",
+    "262144 32 1 45nm 0 0.442865014 0.0123557001 1.06626022",
+    "262144 32 2 45nm 0 0.443057001 0.0184362009 1.19867027",
+    "262144 32 4 45nm 0 0.447941005 0.0227413997 1.17408037",
+    "262144 32 8 45nm 0 0.453354001 0.0333785005 1.16178179",
+    "262144 32 16 45nm 0 0.480607003 0.0678652972 1.25902462",
+    "262144 32 32 45nm 0 0.546899021 0.184761003 1.77880156",
+    "262144 64 1 45nm 0 0.442865014 0.0113933999 1.04585934",
+    "262144 64 2 45nm 0 0.443096012 0.0138098998 1.07673693",
+    "262144 64 4 45nm 0 0.443208009 0.0175244994 1.04738569",
+    "262144 64 8 45nm 0 0.443839014 0.0258760005 1.07087052",
+    "262144 64 16 45nm 0 0.45372501 0.0624440983 1.40204215",
+    "262144 64 32 45nm 0 0.519312978 0.176467001 1.76396954",
+    "262144 128 1 45nm 0 0.442865014 0.0107773002 0.948281825",
+    "262144 128 2 45nm 0 0.443096012 0.0123881996 1.03246081",
+    "262144 128 4 45nm 0 0.443208009 0.0153416004 1.04335618",
+    "262144 128 8 45nm 0 0.443655014 0.0223458 1.06690431",
+    "262144 128 16 45nm 0 0.438964009 0.0557843 1.25764859",
+    "262144 128 32 45nm 0 0.486683011 0.180255994 1.78736115",
+    "524288 8 1 45nm 0 0.554845989 0.0233789999 2.42211914",
+    "524288 8 2 45nm 0 0.672594011 0.0379136987 3.17329431",
+    "524288 8 4 45nm 0 0.688601017 0.0506227985 3.41384554",
+    "524288 8 8 45nm 0 0.71095401 0.0831639022 3.66108418",
+    "524288 8 16 45nm 0 0.757779002 0.145771995 2.9255681",
+    "524288 8 32 45nm 0 0.813040018 0.370236009 5.24040222",
+    "524288 16 1 45nm 0 0.554845989 0.0211817008 2.07745552",
+    "524288 16 2 45nm 0 0.599551022 0.0318288989 3.22325945",
+    "524288 16 4 45nm 0 0.611409009 0.0416793004 3.25842142",
+    "524288 16 8 45nm 0 0.629791021 0.0650682002 2.47913074",
+    "524288 16 16 45nm 0 0.662460983 0.0996586978 3.12328458",
+    "524288 16 32 45nm 0 0.712032974 0.238309994 2.51224971",
+    "524288 32 1 45nm 0 0.554845989 0.0194563009 2.05902004",
+    "524288 32 2 45nm 0 0.564414978 0.0249662995 2.15623665",
+    "524288 32 4 45nm 0 0.570472002 0.0311203003 2.42825079",
+    "524288 32 8 45nm 0 0.57664299 0.0471661985 2.6395812",
+    "524288 32 16 45nm 0 0.590318978 0.0837908015 1.95495999",
+    "524288 32 32 45nm 0 0.63399303 0.207858995 3.54371357",
+    "524288 64 1 45nm 0 0.554845989 0.0182898995 1.86896706",
+    "524288 64 2 45nm 0 0.555203974 0.0219547004 1.91098475",
+    "524288 64 4 45nm 0 0.555306971 0.0275813006 2.09309721",
+    "524288 64 8 45nm 0 0.557524025 0.0394150987 2.12086082",
+    "524288 64 16 45nm 0 0.557197988 0.0665818974 2.17246795",
+    "524288 64 32 45nm 0 0.611468971 0.191264004 3.53743291",
+    "524288 128 1 45nm 0 0.554845989 0.0174291003 1.86906099",
+    "524288 128 2 45nm 0 0.555203974 0.0201848 1.91060877",
+    "524288 128 4 45nm 0 0.555306971 0.0242504999 1.88086402",
+    "524288 128 8 45nm 0 0.555857003 0.0336631015 1.90809262",
+    "524288 128 16 45nm 0 0.557197988 0.0598188005 2.17156315",
+    "524288 128 32 45nm 0 0.584279001 0.182530001 3.53822017",
+    "1048576 8 1 45nm 0 0.687466025 0.0330195017 4.8429513",
+    "1048576 8 2 45nm 0 0.836476028 0.0476243012 6.37134457",
+    "1048576 8 4 45nm 0 0.862215996 0.0784727037 6.43435955",
+    "1048576 8 8 45nm 0 0.883617997 0.123896003 6.32231092",
+    "1048576 8 16 45nm 0 0.930684984 0.205658004 6.27545595",
+    "1048576 8 32 45nm 0 0.994075 0.402166009 6.27914286",
+    "1048576 16 1 45nm 0 0.687466025 0.0295956004 4.36952162",
+    "1048576 16 2 45nm 0 0.741662025 0.0371074006 4.40432692",
+    "1048576 16 4 45nm 0 0.75859499 0.0571479015 5.15531111",
+    "1048576 16 8 45nm 0 0.784300983 0.0878269002 4.91089535",
+    "1048576 16 16 45nm 0 0.824258983 0.152401999 5.23005629",
+    "1048576 16 32 45nm 0 0.852189004 0.296687007 6.28083324",
+    "1048576 32 1 45nm 0 0.687466025 0.0273982994 3.74790859",
+    "1048576 32 2 45nm 0 0.699896991 0.0329362005 4.34893465",
+    "1048576 32 4 45nm 0 0.693966985 0.048168499 4.64665413",
+    "1048576 32 8 45nm 0 0.702264011 0.0701425001 4.96400166",
+    "1048576 32 16 45nm 0 0.723402977 0.112474002 4.64031076",
+    "1048576 32 32 45nm 0 0.75544399 0.204366997 4.78016281",
+    "1048576 64 1 45nm 0 0.687466025 0.0256728996 3.71465659",
+    "1048576 64 2 45nm 0 0.687752008 0.0290673003 3.79283786",
+    "1048576 64 4 45nm 0 0.687896013 0.0378764011 3.9232254",
+    "1048576 64 8 45nm 0 0.689494014 0.0535867997 3.81742907",
+    "1048576 64 16 45nm 0 0.689818025 0.0880054981 3.89845562",
+    "1048576 64 32 45nm 0 0.695765972 0.187058002 4.84065771",
+    "1048576 128 1 45nm 0 0.687466025 0.0245065 3.37189269",
+    "1048576 128 2 45nm 0 0.687752008 0.0274307001 3.72675514",
+    "1048576 128 4 45nm 0 0.687896013 0.0341074988 3.7720921",
+    "1048576 128 8 45nm 0 0.688462973 0.0464081988 3.81709242",
+    "1048576 128 16 45nm 0 0.689818025 0.074663803 3.89761186",
+    "1048576 128 32 45nm 0 0.707983971 0.170765996 4.82811737"
+};
+
+#endif // CACTI_TABLE_45NM_H
@@ -0,0 +1,169 @@
+/**
+ * @file checkpoint.cpp
+ * @details This file contains definitions for the checkpoint writer and reader
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "checkpoint.h"
+
+#include <cstdio>
+
+#include <cache.h>
+#include <main_memory.h>
+#include <sweep.h>
+#include <trace_reader.h>
+
+bool ckpt_writer::write(const std::string& path) const
+{
+    FILE* file = fopen(path.c_str(), "wb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    bool is_written = fwrite(_buf.data(), 1, _buf.size(), file) == _buf.size();
+    return fclose(file) == 0 && is_written;
+}
+
+bool ckpt_reader::read(const std::string& path)
+{
+    _buf.clear();
+    _pos = 0;
+    _is_ok = false;
+
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr) {
+        return false;
+    }
+
+    // one read of the whole image
+    if (fseek(file, 0, SEEK_END) == 0)
+    {
+        long size = ftell(file);
+        if (size >= 0 && fseek(file, 0, SEEK_SET) == 0)
+        {
+            _buf.resize(size);
+            _is_ok = fread(_buf.data(), 1, _buf.size(), file) == _buf.size();
+        }
+    }
+    fclose(file);
+
+    return _is_ok;
+}
+
+/**
+ * @details The configuration a checkpoint was taken with, fixed width
+ */
+static void put_config(ckpt_writer& out, const sim_config& cfg)
+{
+    uint32_t sizes[7] = {cfg.l1_size, cfg.l1_assoc, cfg.l1_block_size, cfg.vc_num_blocks, cfg.l2_size, cfg.l2_assoc,
+                         static_cast<uint32_t>(cfg.repl_policy)};
+    out.put_array(sizes, 7);
+    out.put<uint64_t>(cfg.repl_seed);
+}
+
+/**
+ * @details The optional state the hierarchy keeps, every level keeps the same
+ */
+static uint16_t get_options(const cache& l1)
+{
+    return (l1.has_set_counters() ? ckpt::HAS_SET_COUNTERS : 0) | (l1.has_miss_classes() ? ckpt::HAS_MISS_CLASSES : 0);
+}
+
+bool save_checkpoint(const std::string& path, const sim_config& cfg, const trace_reader& trace, uint64_t num_records,
+    const cache& l1, const cache* l2, const main_memory& mem)
+{
+    ckpt_writer out;
+
+    ckpt::header hdr = {};
+    std::memcpy(hdr.magic, ckpt::MAGIC, sizeof(hdr.magic));
+    hdr.version = ckpt::VERSION;
+    hdr.options = get_options(l1);
+    hdr.num_records = num_records;
+    hdr.trace_size = trace.get_size();
+    hdr.trace_hash = trace.get_sample_hash();
+    out.put(hdr);
+
+    put_config(out, cfg);
+
+    l1.save(out);
+    if (l2 != nullptr) {
+        l2->save(out);
+    }
+    mem.save(out);
+
+    return out.write(path);
+}
+
+bool restore_checkpoint(const std::string& path, const sim_config& cfg, const trace_reader& trace, uint64_t& num_records,
+    cache& l1, cache* l2, main_memory& mem, std::string& err)
+{
+    ckpt_reader in;
+    if (!in.read(path))
+    {
+        err = "Unable to read checkpoint";
+        return false;
+    }
+
+    ckpt::header hdr;
+    if (!in.get(hdr) || std::memcmp(hdr.magic, ckpt::MAGIC, sizeof(hdr.magic)) != 0)
+    {
+        err = "Not a checkpoint";
+        return false;
+    }
+    if (hdr.version != ckpt::VERSION)
+    {
+        err = "Checkpoint version " + std::to_string(hdr.version) + " is not supported";
+        return false;
+    }
+
+    // the configuration must be the one running, byte for byte
+    ckpt_writer expected;
+    put_config(expected, cfg);
+    std::vector<uint8_t> config(expected.get_size());
+    if (!in.get_array(config.data(), config.size()))
+    {
+        err = "Truncated checkpoint";
+        return false;
+    }
+
+    if (std::memcmp(config.data(), expected.data(), config.size()) != 0)
+    {
+        err = "Checkpoint was taken with another cache configuration";
+        return false;
+    }
+
+    // the state restored is only that of the same prefix of the same trace
+    if (hdr.trace_size != trace.get_size())
+    {
+        err = "Checkpoint was taken on a trace of " + std::to_string(hdr.trace_size) + " bytes, this one has " +
+            std::to_string(trace.get_size());
+        return false;
+    }
+    if (hdr.trace_hash != trace.get_sample_hash())
+    {
+        err = "Checkpoint was taken on another trace of the same size";
+        return false;
+    }
+
+    // counters this run keeps must cover the records before the checkpoint, those it does not keep are dropped
+    uint16_t missing = get_options(l1) & ~hdr.options;
+    if (missing & ckpt::HAS_SET_COUNTERS)
+    {
+        err = "Checkpoint was taken without --set-stats, per set counters would miss the records before it";
+        return false;
+    }
+    if (missing & ckpt::HAS_MISS_CLASSES)
+    {
+        err = "Checkpoint was taken without --classify-misses, misses before it would not be classified";
+        return false;
+    }
+
+    if (!l1.restore(in) || (l2 != nullptr && !l2->restore(in)) || !mem.restore(in) || !in.is_done())
+    {
+        err = "Checkpoint state does not match the cache configuration";
+        return false;
+    }
+
+    num_records = hdr.num_records;
+    return true;
+}
@@ -0,0 +1,236 @@
+/**
+ * @file checkpoint.h
+ * @details This file contains the checkpoint file format and its raw state writer and reader
+ *
+ * A checkpoint is a ckpt::header followed by the configuration it was taken with and then the
+ * state of every level, closest to the core first, as each level writes it. The header names the
+ * trace it was taken on and the optional state it holds. State is written as raw
+ * arrays in the byte order of the machine that took it, so restoring is a handful of copies whatever
+ * the size of the caches.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+namespace ckpt
+{
+    const char MAGIC[8] = {'C', 'S', 'I', 'M', 'C', 'K', 'P', '\0'};
+    const uint16_t VERSION = 5;
+
+    // optional state held by the checkpoint, flags of header.options
+    const uint16_t HAS_SET_COUNTERS = 1;
+    const uint16_t HAS_MISS_CLASSES = 2;
+
+    /**
+     * @details File header
+     */
+    struct header
+    {
+        char magic[8];
+        uint16_t version;
+        uint16_t options;
+        uint16_t reserved[2];
+
+        // trace records simulated before the checkpoint was taken
+        uint64_t num_records;
+
+        // the trace it was taken on, by size and sampled hash
+        uint64_t trace_size;
+        uint64_t trace_hash;
+    };
+}
+
+/**
+ * @details Appends state to a checkpoint image in memory
+ */
+class ckpt_writer
+{
+    private:
+        std::vector<uint8_t> _buf;
+
+    public:
+
+        /**
+         * @details Append a plain value
+         */
+        template <typename T>
+        void put(const T& val)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only plain values are written raw");
+            put_raw(&val, sizeof(T));
+        }
+
+        /**
+         * @details Append num plain values
+         */
+        template <typename T>
+        void put_array(const T* vals, size_t num)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only plain values are written raw");
+            put_raw(vals, num * sizeof(T));
+        }
+
+        /**
+         * @details Append a vector with its length
+         */
+        template <typename T>
+        void put_vec(const std::vector<T>& vec)
+        {
+            put<uint64_t>(vec.size());
+            put_array(vec.data(), vec.size());
+        }
+
+        void put_raw(const void* data, size_t len)
+        {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            _buf.insert(_buf.end(), bytes, bytes + len);
+        }
+
+        /**
+         * @details Write the image to path, false if it could not be written
+         */
+        bool write(const std::string& path) const;
+
+        const uint8_t* data() const {
+            return _buf.data();
+        }
+
+        size_t get_size() const {
+            return _buf.size();
+        }
+};
+
+/**
+ * @details Reads state back out of a checkpoint image. Any read past the end or into state of a
+ * different shape fails the reader, which stays failed
+ */
+class ckpt_reader
+{
+    private:
+        std::vector<uint8_t> _buf;
+        size_t _pos;
+        bool _is_ok;
+
+    public:
+
+        ckpt_reader() : _pos(0), _is_ok(false) {}
+
+        /**
+         * @details Read the image at path, false if it could not be read
+         */
+        bool read(const std::string& path);
+
+        /**
+         * @details Read a plain value
+         */
+        template <typename T>
+        bool get(T& val)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only plain values are read raw");
+            return get_raw(&val, sizeof(T));
+        }
+
+        /**
+         * @details Read num plain values
+         */
+        template <typename T>
+        bool get_array(T* vals, size_t num)
+        {
+            static_assert(std::is_trivially_copyable<T>::value, "only plain values are read raw");
+            return get_raw(vals, num * sizeof(T));
+        }
+
+        /**
+         * @details Read a vector that must have the length vec already has
+         */
+        template <typename T>
+        bool get_vec(std::vector<T>& vec)
+        {
+            uint64_t size = 0;
+            if (!get(size) || size != vec.size()) {
+                return fail();
+            }
+            return get_array(vec.data(), vec.size());
+        }
+
+        /**
+         * @details Read a value and check that it is expected
+         */
+        template <typename T>
+        bool expect(const T& expected)
+        {
+            T val;
+            if (!get(val) || std::memcmp(&val, &expected, sizeof(T)) != 0) {
+                return fail();
+            }
+            return true;
+        }
+
+        bool get_raw(void* data, size_t len)
+        {
+            if (!_is_ok || _buf.size() - _pos < len) {
+                return fail();
+            }
+            std::memcpy(data, _buf.data() + _pos, len);
+            _pos += len;
+            return true;
+        }
+
+        /**
+         * @details Mark the image as not matching what is restored
+         */
+        bool fail()
+        {
+            _is_ok = false;
+            return false;
+        }
+
+        bool is_ok() const {
+            return _is_ok;
+        }
+
+        /**
+         * @details Bytes not read yet
+         */
+        size_t get_left() const {
+            return _buf.size() - _pos;
+        }
+
+        /**
+         * @details Check that the whole image was read
+         */
+        bool is_done() const {
+            return _is_ok && _pos == _buf.size();
+        }
+};
+
+class cache;
+class main_memory;
+class trace_reader;
+struct sim_config;
+
+/**
+ * @details Write a checkpoint of the hierarchy cfg describes to path, taken after num_records records
+ * of trace. l2 is null without L2. False if the file could not be written
+ */
+bool save_checkpoint(const std::string& path, const sim_config& cfg, const trace_reader& trace, uint64_t num_records,
+    const cache& l1, const cache* l2, const main_memory& mem);
+
+/**
+ * @details Restore the hierarchy cfg describes out of the checkpoint at path and get the number of records
+ * of trace it was taken after. Refused when taken on another trace or without state this run keeps. On a
+ * false return err says why, the hierarchy may be partly restored
+ */
+bool restore_checkpoint(const std::string& path, const sim_config& cfg, const trace_reader& trace, uint64_t& num_records,
+    cache& l1, cache* l2, main_memory& mem, std::string& err);
+
+#endif // CHECKPOINT_H
@@ -13,4 +13,103 @@ const std::string to_hex_str(unsigned val)
     ss << std::hex << val;
     ss.flags(old_flags);
     return ss.str();
-}
\ No newline at end of file
+}
+const char* log_lvl_str(verbose level)
+{
+    switch(level){
+        case(verbose::DEBUG) : return "DEBUG";
+        case(verbose::INFO) : return "INFO";
+        case(verbose::FATAL) : return "FATAL";
+        case(verbose::ERROR) : return "ERROR";
+        case(verbose::WARN) : return "WARN";
+    }
+    return "";
+}
+
+void format_log(std::string& out, const char* fmt, const log_arg* args, size_t num_args)
+{
+    static const char digits[] = "0123456789abcdef";
+
+    size_t next_arg = 0;
+    for (const char* p = fmt; *p != '\0'; p++)
+    {
+        if (*p != '%')
+        {
+            out.push_back(*p);
+            continue;
+        }
+
+        // skip flags, width and length modifiers
+        p++;
+        while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || (*p >= '0' && *p <= '9') ||
+            *p == 'l' || *p == 'h' || *p == 'z' || *p == 'j') {
+            p++;
+        }
+
+        if (*p == '\0') {
+            break;
+        }
+        if (*p == '%')
+        {
+            out.push_back('%');
+            continue;
+        }
+
+        // a missing argument prints as nothing
+        if (next_arg == num_args) {
+            continue;
+        }
+        const log_arg& arg = args[next_arg++];
+
+        if (*p == 's')
+        {
+            out.append(arg.str != nullptr ? arg.str : "");
+            continue;
+        }
+
+        uint64_t val = arg.val;
+        bool is_neg = *p == 'd' || *p == 'i' ? (int64_t) val < 0 : false;
+        if (is_neg)
+        {
+            out.push_back('-');
+            val = 0 - val;
+        }
+
+        unsigned radix = *p == 'x' ? 16 : 10;
+        char buf[24];
+        size_t len = 0;
+        do
+        {
+            buf[len++] = digits[val % radix];
+            val = val / radix;
+        } while (val != 0);
+
+        while (len > 0) {
+            out.push_back(buf[--len]);
+        }
+    }
+}
+
+void logger::emit(base* base_ptr, verbose level, const char* fmt, const log_arg* args, size_t num_args)
+{
+    if (level == verbose::DEBUG && _sink != nullptr)
+    {
+        _sink->record(base_ptr, level, fmt, args, num_args);
+        return;
+    }
+
+    // the whole line goes out in one write so threads do not split each other's lines,
+    // the buffer is reused by every message printed from this thread and only grows past a typical line
+    thread_local std::string line;
+    if (line.capacity() < LOG_LINE_RESERVE) {
+        line.reserve(LOG_LINE_RESERVE);
+    }
+    line.assign(log_lvl_str(level));
+    line.append(": ");
+    line.append(base_ptr->get_name());
+    line.append(" :: ");
+    format_log(line, fmt, args, num_args);
+    line.push_back('\n');
+
+    std::cout << line << std::flush;
+}
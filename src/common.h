@@ -10,6 +10,10 @@
 #include <string>
 #include <iostream>
 #include <sstream>
+#include <cstdint>
+#include <type_traits>
+#include <limits>
+#include <stdexcept>
 
 #include <base.h>
 
@@ -24,11 +28,87 @@ enum verbose{
     DEBUG,
 };
 
+/**
+ * Highest level compiled into the logger, e.g. -DLOG_MAX_LEVEL=INFO. Calls of the
+ * templated log above it compile to nothing, arguments included
+ */
+#ifndef LOG_MAX_LEVEL
+#define LOG_MAX_LEVEL DEBUG
+#endif
+
+const verbose log_max_level = verbose::LOG_MAX_LEVEL;
+
 /**
  * @details Function that converts integer to string hex
  */
 const std::string to_hex_str(unsigned val);
 
+/**
+ * @details Parse whole decimal text, such as an argument, into T. Throws std::invalid_argument on anything but digits
+ * and std::out_of_range on a value T cannot hold
+ */
+template<typename T>
+T parse_number(const std::string& text)
+{
+    // std::stoull takes a minus sign and wraps the value around
+    if (text.empty() || text[0] == '-') {
+        throw std::invalid_argument(text);
+    }
+
+    size_t end = 0;
+    unsigned long long val = std::stoull(text, &end);
+    if (end != text.size()) {
+        throw std::invalid_argument(text);
+    }
+    if (val > std::numeric_limits<T>::max()) {
+        throw std::out_of_range(text);
+    }
+    return (T) val;
+}
+
+/**
+ * @details Printable name of a logging level
+ */
+const char* log_lvl_str(verbose level);
+
+/**
+ * @details One argument of a lazily formatted message, an integer or a string
+ */
+struct log_arg
+{
+    uint64_t val;
+    const char* str;
+
+    log_arg(const char* str) : val(0), str(str) {}
+    log_arg(const std::string& str) : val(0), str(str.c_str()) {}
+
+    template<typename T, typename = std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>>>
+    log_arg(T val) : val((uint64_t) (int64_t) val), str(nullptr) {}
+};
+
+// arguments a message can take
+const size_t LOG_MAX_ARGS = 8;
+
+// bytes reserved for a printed line
+const size_t LOG_LINE_RESERVE = 256;
+
+/**
+ * @details Expand a printf-style format into out. Conversions are %d, %u, %x and %s, flags,
+ * width and length modifiers are accepted and ignored, %% prints a percent sign
+ */
+void format_log(std::string& out, const char* fmt, const log_arg* args, size_t num_args);
+
+/**
+ * @details Receiver of DEBUG messages instead of the console. Gets the unformatted message, the
+ * format and arguments are only valid during the call
+ */
+class log_event_sink
+{
+    public:
+        virtual void record(base* base_ptr, verbose level, const char* fmt, const log_arg* args, size_t num_args) = 0;
+        virtual ~log_event_sink() {}
+};
+
 /**
  * @details This class employs a logger function
  */
@@ -36,6 +116,15 @@ class logger : public base
 {
     private:
         verbose log_lvl;
+
+        // DEBUG messages go here instead of the console when set
+        log_event_sink* _sink;
+
+        /**
+         * @details Print or record a message that passed the level checks
+         */
+        void emit(base* base_ptr, verbose level, const char* fmt, const log_arg* args, size_t num_args);
+
     public:
 
         /**
@@ -45,6 +134,7 @@ class logger : public base
         {
             // get the logger level
             log_lvl = verbose::INFO;
+            _sink = nullptr;
         }
         
         /**
@@ -53,28 +143,54 @@ class logger : public base
         logger(verbose level) : base("Logger")
         {
             log_lvl = level;
+            _sink = nullptr;
+        }
+
+        /**
+         * @details Send DEBUG messages to sink, nullptr prints them again. Copies of the logger made
+         * afterwards share the sink
+         */
+        void set_sink(log_event_sink* sink) {
+            _sink = sink;
         }
 
         /**
          * @details Log a message
          */
-        void log(base* base_ptr, verbose level, const std::string& msg)
+        void log(base* base_ptr, verbose level, const std::string& msg) {
+            log(base_ptr, level, msg.c_str());
+        }
+
+        /**
+         * @details Log a fixed message without building a string
+         */
+        void log(base* base_ptr, verbose level, const char* msg)
         {
-            // TODO
-            // Should be a better way to do this 
-            std::string lvl_str = "";
-            switch(level){
-                case(verbose::DEBUG) : lvl_str = "DEBUG"; break;
-                case(verbose::INFO) : lvl_str = "INFO"; break;
-                case(verbose::FATAL) : lvl_str = "FATAL"; break;
-                case(verbose::ERROR) : lvl_str = "ERROR"; break;
-                case(verbose::WARN) : lvl_str = "WARN"; break;
+            // print if the logging level specified is higher than static
+            if (level <= log_max_level && level <= log_lvl)
+            {
+                log_arg arg(msg);
+                emit(base_ptr, level, "%s", &arg, 1);
             }
+        }
 
-            // print if the logging level specified is higher than static
-            if (level <= log_lvl)
+        /**
+         * @details Log a printf-style message. Above LOG_MAX_LEVEL the call is compiled out, below it
+         * the arguments are only formatted when the level is printed, so a filtered message costs a
+         * compare
+         */
+        template<verbose LEVEL, typename... ARGS>
+        void log(base* base_ptr, const char* fmt, const ARGS&... args)
+        {
+            static_assert(sizeof...(ARGS) <= LOG_MAX_ARGS, "too many log arguments");
+
+            if constexpr (LEVEL <= log_max_level)
             {
-                std::cout << lvl_str << ": " << base_ptr->get_name() << " :: " << msg << std::endl;
+                if (LEVEL <= log_lvl)
+                {
+                    const log_arg packed[sizeof...(ARGS) + 1] = {log_arg(args)..., log_arg(0)};
+                    emit(base_ptr, LEVEL, fmt, packed, sizeof...(ARGS));
+                }
             }
         }
 };
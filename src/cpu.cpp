@@ -6,97 +6,371 @@
 
 #include "cpu.h"
 
+#include <thread>
+#include <algorithm>
+
+#include <spsc_ring.h>
+
 cpu::cpu(const std::string &path, const logger& log_obj) : module("Core", log_obj)
 {
-    log.log(this, verbose::DEBUG, "Constructing CPU");
+    log.log<verbose::DEBUG>(this, "Constructing CPU");
 
     // CPU issues all requests to the memory hierarchy
     this->mk_prev_connection(nullptr);
 
     // trace file path
     _trace_file_path = path;
+    _trace = nullptr;
+
+    // issue one request at a time and decode inline by default
+    _batch_size = 0;
+    _first_record = 0;
+    _max_records = UINT64_MAX;
+    _num_issued = 0;
+    _prof = nullptr;
+    _prof_decode_stage = 0;
+    _prof_stage = 0;
+    _sampler = nullptr;
+    _next_sample = 0;
+    _alloc_warmup = UINT64_MAX;
+    _warm_allocs = UINT64_MAX;
+    _last_allocs = UINT64_MAX;
+    _is_pipelined = false;
+    _decode_batch_size = 1024;
+    _ring_batches = 64;
+}
+
+cpu::cpu(const std::vector<mem_req>& trace, const logger& log_obj) : cpu("", log_obj)
+{
+    _trace = &trace;
+}
+
+void cpu::set_batch_size(size_t batch_size)
+{
+    _batch_size = batch_size;
+
+    // the decoder fills batches of the issue size
+    _decode_batch_size = batch_size > 0 ? batch_size : 1024;
+}
+
+void cpu::set_pipelined(bool enable, size_t ring_batches)
+{
+    _is_pipelined = enable;
+    _ring_batches = ring_batches > 0 ? ring_batches : 1;
+}
+
+void cpu::set_range(uint64_t first, uint64_t max_records)
+{
+    _first_record = first;
+    _max_records = max_records;
+}
+
+void cpu::set_profiler(profiler* prof)
+{
+    _prof = prof;
+    if (_prof != nullptr)
+    {
+        _prof_decode_stage = _prof->add_stage("Trace decode");
+        _prof_stage = _prof->add_stage(get_name());
+    }
+}
+
+void cpu::set_sampler(interval_sampler* sampler)
+{
+    _sampler = sampler;
+    if (_sampler != nullptr) {
+        _next_sample = _num_issued + _sampler->get_interval();
+    }
 }
 
 void cpu::sequencer()
 {
-    log.log(this, verbose::DEBUG, "Reading trace file: " + _trace_file_path);
-    
-    std::ifstream stream(_trace_file_path);
+    prof_scope scope(_prof, _prof_stage);
 
-    // temp variables 
-    std::string line;
-    std::string opr;
+    if (_trace != nullptr)
+    {
+        sequence_decoded();
+        log.log<verbose::DEBUG>(this, "Execution completed!");
+        return;
+    }
 
-    // line counter
-    unsigned count = 1;
+    log.log<verbose::DEBUG>(this, "Reading trace file: %s", _trace_file_path);
+    
+    trace_reader trace(_trace_file_path);
 
     // error flag
     bool err = false;
 
-    if (stream.is_open())
+    if (trace.is_open())
     {   
-        while (getline(stream, line))
+        if (seek(trace)) {
+            err = true;
+        }
+        else
         {
-            
-            mem_req* req_msg = new mem_req;
+            if (_sampler != nullptr) {
+                _sampler->begin(_num_issued, trace.get_offset(), trace.get_size());
+            }
 
-            log.log(this, verbose::DEBUG, "Reading line: " + line);
+            if (_is_pipelined) {
+                err = sequence_pipelined(trace);
+            } else {
+                err = sequence_inline(trace);
+            }
 
-            count = count + 1;
+            if (_sampler != nullptr) {
+                _sampler->set_done(trace.get_offset());
+            }
+        }
+    }
+    else {
+        // file is not open yet
+        log.log(this, verbose::FATAL, _trace_file_path + ": Unable to find file");
+    }
+
+    // execution is done
+    if (err) {
+        log.log(this, verbose::ERROR, "Ending with errors");
+    } else {
+        log.log<verbose::DEBUG>(this, "Execution completed!");
+    }
+}
+
+bool cpu::seek(trace_reader& trace)
+{
+    if (_first_record == 0) {
+        return false;
+    }
 
-            std::stringstream ss(line);
+    log.log<verbose::DEBUG>(this, "Skipping %lu records", _first_record);
 
-            // get opr type
-            ss >> opr;
-            if (opr == "r") {
-                req_msg->req_op_type = OP_TYPE::LOAD;
-            }
-            else if (opr == "w") {
-                req_msg->req_op_type = OP_TYPE::STORE;
-            }
-            else 
+    // a trace ending before the range simply has nothing left to issue
+    TRACE_STATUS status = trace.skip(_first_record);
+    return status != TRACE_STATUS::END_OF_TRACE && report_status(status, trace.get_line());
+}
+
+bool cpu::sequence_inline(trace_reader& trace)
+{
+    TRACE_STATUS status = TRACE_STATUS::VALID;
+    uint64_t left = _max_records;
+
+    if (_batch_size > 0)
+    {
+        std::vector<mem_req> batch(_batch_size);
+        size_t count;
+
+        do
+        {
+            count = 0;
             {
-                // log an error
-                log.log(this, verbose::FATAL, _trace_file_path + ": Invalid request format at line " + std::to_string(count));
-                err = true;
-                break;
+                prof_scope decode(_prof, _prof_decode_stage);
+                while (count < _batch_size && left > 0 && (status = trace.next(batch[count])) == TRACE_STATUS::VALID)
+                {
+                    count++;
+                    left--;
+                }
             }
+            issue(batch.data(), count, trace.get_offset());
+        } while (status == TRACE_STATUS::VALID && left > 0);
+
+        return report_status(status, trace.get_line());
+    }
+
+    mem_req req_msg;
+
+    while (left > 0)
+    {
+        {
+            prof_scope decode(_prof, _prof_decode_stage);
+            status = trace.next(req_msg);
+        }
+        if (status != TRACE_STATUS::VALID) {
+            break;
+        }
+
+        left--;
+        _num_issued++;
+
+        // register this request
+        req_ptr_next = &req_msg;
+
+        // send out a request through put next port
+        put_to_next(req_ptr_next);
 
-            // get address
-            ss >> opr;
-            try {
-               req_msg->addr = std::stoul(opr, nullptr, 16);
+        if (_sampler != nullptr && _num_issued >= _next_sample) {
+            take_sample(trace.get_offset());
+        }
+        mark_allocs();
+    }
+
+    // the request only lives for this call
+    req_ptr_next = nullptr;
+
+    return report_status(status, trace.get_line());
+}
+
+bool cpu::sequence_pipelined(trace_reader& trace)
+{
+    log.log<verbose::DEBUG>(this, "Decoding trace on a background thread");
+
+    // all batch buffers are allocated up front and reused in place
+    trace_batch init;
+    init.reqs.resize(_decode_batch_size);
+    spsc_ring<trace_batch> ring(_ring_batches, init);
+
+    // producer: decode the trace into batches
+    std::thread producer([&]()
+    {
+        TRACE_STATUS status = TRACE_STATUS::VALID;
+        uint64_t left = _max_records;
+        while (status == TRACE_STATUS::VALID)
+        {
+            trace_batch* batch = ring.produce();
+
+            batch->count = 0;
+            while (batch->count < _decode_batch_size && left > 0 &&
+                   (status = trace.next(batch->reqs[batch->count])) == TRACE_STATUS::VALID)
+            {
+                batch->count++;
+                left--;
             }
-            catch (const std::invalid_argument&) {
-               log.log(this, verbose::FATAL, _trace_file_path + ": Cannot convert address hex to int at line " + std::to_string(count));
-               err = false;
-               break;
+
+            // the end of the range ends the trace
+            if (left == 0 && status == TRACE_STATUS::VALID) {
+                status = TRACE_STATUS::END_OF_TRACE;
             }
+            batch->status = status;
+            batch->line = trace.get_line();
+            batch->offset = trace.get_offset();
 
+            ring.commit();
+        }
+    });
+
+    // consumer: simulate requests in trace order
+    bool err = false;
+    bool done = false;
+    unsigned long num_batches = 0;
+    while (!done)
+    {
+        trace_batch* batch;
+        {
+            // waiting for the decoder
+            prof_scope decode(_prof, _prof_decode_stage);
+            batch = ring.consume();
+        }
+
+        issue(batch->reqs.data(), batch->count, batch->offset);
+
+        if (batch->status != TRACE_STATUS::VALID)
+        {
+            err = report_status(batch->status, batch->line);
+            done = true;
+        }
+
+        ring.release();
+        num_batches++;
+    }
+
+    producer.join();
+
+    log.log<verbose::INFO>(this, "Trace pipeline: %lu batches, decoder stalled %lu times on a full ring, simulator stalled %lu times on an empty ring",
+        num_batches, ring.get_producer_stalls(), ring.get_consumer_stalls());
+
+    return err;
+}
+
+void cpu::sequence_decoded()
+{
+    // requests are copied out batch by batch, the shared trace is never handed to the hierarchy
+    std::vector<mem_req> batch(_decode_batch_size);
+
+    size_t first = std::min<uint64_t>(_first_record, _trace->size());
+    size_t end = first + std::min<uint64_t>(_max_records, _trace->size() - first);
+
+    // progress is counted in records
+    if (_sampler != nullptr) {
+        _sampler->begin(_num_issued, first, _trace->size());
+    }
+
+    for (size_t pos = first; pos < end; pos += batch.size())
+    {
+        size_t count = std::min(batch.size(), end - pos);
+        std::copy(_trace->begin() + pos, _trace->begin() + pos + count, batch.begin());
+        issue(batch.data(), count, pos + count);
+    }
+
+    if (_sampler != nullptr) {
+        _sampler->set_done(end);
+    }
+}
+
+void cpu::issue(mem_req* reqs, size_t count, uint64_t done)
+{
+    while (_sampler != nullptr && count > 0 && _num_issued + count >= _next_sample)
+    {
+        size_t part = _next_sample - _num_issued;
+        send(reqs, part);
+        take_sample(done);
+
+        reqs += part;
+        count -= part;
+    }
+
+    send(reqs, count);
+}
+
+void cpu::take_sample(uint64_t done)
+{
+    _sampler->sample(_num_issued, done);
+    _next_sample = _num_issued + _sampler->get_interval();
+}
+
+void cpu::send(mem_req* reqs, size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+
+    _num_issued += count;
+
+    if (_batch_size > 0) {
+        put_batch_to_next(reqs, count);
+    }
+    else
+    {
+        for (size_t i = 0; i < count; i++)
+        {
             // register this request
-            req_ptr_next = req_msg;
+            req_ptr_next = &reqs[i];
 
             // send out a request through put next port
-            put_to_next(req_msg);
-            
-            // dequeue the request
-            delete req_msg;
+            put_to_next(req_ptr_next);
         }
     }
-    else {
-        // file is not open yet
-        log.log(this, verbose::FATAL, _trace_file_path + ": Unable to find file");
-    }
 
-    // execution is done
-    if (err) {
-        log.log(this, verbose::ERROR, "Ending with errors");
-    } else {
-        log.log(this, verbose::DEBUG, "Execution completed!");
+    mark_allocs();
+}
+
+bool cpu::report_status(TRACE_STATUS status, uint64_t line)
+{
+    switch (status)
+    {
+        case (TRACE_STATUS::INVALID_OP) :
+            log.log(this, verbose::FATAL, _trace_file_path + ": Invalid request format at line " + std::to_string(line));
+            return true;
+        case (TRACE_STATUS::INVALID_ADDR) :
+            log.log(this, verbose::FATAL, _trace_file_path + ": Cannot convert address hex to int at line " + std::to_string(line));
+            return true;
+        case (TRACE_STATUS::CORRUPT) :
+            log.log(this, verbose::FATAL, _trace_file_path + ": Corrupt binary trace at record " + std::to_string(line));
+            return true;
+        default :
+            return false;
     }
 }
 
 void cpu::get_frm_next()
 {
-    log.log(this, verbose::DEBUG, "Committing " + req_ptr_next->get_msg_str());
+    log.log<verbose::DEBUG>(this, "Committing " MEM_REQ_FMT, req_ptr_next->req_op_type, req_ptr_next->addr);
 }
\ No newline at end of file
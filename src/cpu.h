@@ -9,12 +9,34 @@
 
 // standard includes
 #include <string>
-#include <fstream>
-#include <sstream>
+#include <vector>
+#include <cstdint>
 
 // local includes
 #include <module.h>
 #include <common.h>
+#include <trace_reader.h>
+#include <profiler.h>
+#include <interval.h>
+#include <alloc_count.h>
+
+/**
+ * @details A batch of decoded trace records handed from the decoding thread to the simulator
+ */
+struct trace_batch
+{
+    std::vector<mem_req> reqs;
+    size_t count;
+
+    // status that ended this batch, VALID if more batches follow
+    TRACE_STATUS status;
+    uint64_t line;
+
+    // bytes of the trace consumed once this batch was decoded
+    size_t offset;
+
+    trace_batch() : count(0), status(TRACE_STATUS::VALID), line(0), offset(0) {}
+};
 
 /**
  * @details This class mimics a CPU issuing memory requests to the next memory module
@@ -23,6 +45,94 @@ class cpu : public module
 {
     private:
        std::string _trace_file_path;
+
+       // already decoded trace shared with other cores, nullptr when reading the trace file
+       const std::vector<mem_req>* _trace;
+
+       // requests per batch handed to the next level, 0 sends them one at a time
+       size_t _batch_size;
+
+       // records skipped before issuing and records issued at most
+       uint64_t _first_record;
+       uint64_t _max_records;
+
+       // records issued so far
+       uint64_t _num_issued;
+
+       // profiler of the sequencer and its stages, nullptr when not profiling
+       profiler* _prof;
+       unsigned _prof_decode_stage;
+       unsigned _prof_stage;
+
+       // interval sampler, nullptr when not sampling, and the issue count its next sample is due at
+       interval_sampler* _sampler;
+       uint64_t _next_sample;
+
+       // heap allocations made by the time the first _alloc_warmup records were issued, UINT64_MAX until
+       // then, and by the time the last request was sent
+       uint64_t _alloc_warmup;
+       uint64_t _warm_allocs;
+       uint64_t _last_allocs;
+
+       // pipelined trace decoding
+       bool _is_pipelined;
+       size_t _decode_batch_size;
+       size_t _ring_batches;
+
+        /**
+         * @details Send count requests to the next level, as a batch or one by one
+         */
+        void send(mem_req* reqs, size_t count);
+
+        /**
+         * @details Send count requests, done of the trace being consumed once they are. A batch is split at
+         * interval boundaries so every sample ends an interval exactly
+         */
+        void issue(mem_req* reqs, size_t count, uint64_t done);
+
+        /**
+         * @details Take the sample due at this point, done of the trace consumed
+         */
+        void take_sample(uint64_t done);
+
+        /**
+         * @details Count allocations once the warm-up records were issued
+         */
+        void mark_allocs()
+        {
+            if (_num_issued >= _alloc_warmup)
+            {
+                _last_allocs = alloc_count::get();
+                if (_warm_allocs == UINT64_MAX) {
+                    _warm_allocs = _last_allocs;
+                }
+            }
+        }
+
+        /**
+         * @details Log a trace decoding error, returns true if status is an error
+         */
+        bool report_status(TRACE_STATUS status, uint64_t line);
+
+        /**
+         * @details Skip the trace to the first record of the range, returns true on an error
+         */
+        bool seek(trace_reader& trace);
+
+        /**
+         * @details Decode and issue requests one after another on this thread
+         */
+        bool sequence_inline(trace_reader& trace);
+
+        /**
+         * @details Decode on a producer thread and issue requests drained from a ring on this thread
+         */
+        bool sequence_pipelined(trace_reader& trace);
+
+        /**
+         * @details Issue the requests of an already decoded trace
+         */
+        void sequence_decoded();
     
     public:
 
@@ -31,6 +141,70 @@ class cpu : public module
          */
         cpu(const std::string& path, const logger& log);
 
+        /**
+         * @details Constructor that replays an already decoded trace, which is only read and may be
+         * shared between cpus running on different threads
+         */
+        cpu(const std::vector<mem_req>& trace, const logger& log);
+
+        /**
+         * @details Issue requests to the next level in batches of batch_size, 0 issues them one at a time
+         */
+        void set_batch_size(size_t batch_size);
+
+        /**
+         * @details Enable decoding the trace on a background thread, feeding batches of decoded
+         * requests through a ring of ring_batches slots
+         */
+        void set_pipelined(bool enable, size_t ring_batches = 64);
+
+        /**
+         * @details Only issue the records from first on, at most max_records of them. The records before
+         * first are skipped without being decoded where the trace format allows
+         */
+        void set_range(uint64_t first, uint64_t max_records = UINT64_MAX);
+
+        /**
+         * @details Charge the sequencer to prof, trace decoding apart. Stages are added for both
+         */
+        void set_profiler(profiler* prof);
+
+        /**
+         * @details Sample the counters with sampler every interval of issued records, from the next
+         * record on
+         */
+        void set_sampler(interval_sampler* sampler);
+
+        /**
+         * @details Take the heap allocation count once records records were issued, so the allocations
+         * of the steady state after them are known
+         */
+        void set_alloc_warmup(uint64_t records) {
+            _alloc_warmup = records;
+        }
+
+        /**
+         * @details Heap allocations made from the end of the warm-up up to the last request sent, end of
+         * run reporting excluded. UINT64_MAX if the warm-up did not end
+         */
+        uint64_t get_steady_allocs() const {
+            return _warm_allocs == UINT64_MAX ? UINT64_MAX : _last_allocs - _warm_allocs;
+        }
+
+        /**
+         * @details Stage the sequencer is charged to
+         */
+        unsigned get_prof_stage() const {
+            return _prof_stage;
+        }
+
+        /**
+         * @details Number of records issued by the sequencer so far
+         */
+        uint64_t get_num_issued() const {
+            return _num_issued;
+        }
+
         /**
          * @details Sequencer that sequences memory accesses
          */
@@ -0,0 +1,85 @@
+/**
+ * @file hierarchy.cpp
+ * @details This file contains the static hierarchies compiled for common shapes
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "hierarchy.h"
+
+/**
+ * @details Build the hierarchy of an L1 geometry and an L2 shape, L2_SETS 0 for no L2
+ */
+template <typename L1_GEOM, unsigned L2_SETS, unsigned L2_ASSOC>
+static std::unique_ptr<module> build_hierarchy(cache& l1, cache* l2, main_memory& mem, const logger& log)
+{
+    typedef cache_level<L1_GEOM, lru_policy> l1_level;
+
+    if constexpr (L2_SETS == 0) {
+        return std::unique_ptr<module>(new hierarchy<l1_level, memory_level>(log, l1_level(l1), memory_level(mem)));
+    }
+    else
+    {
+        typedef cache_level<static_geometry<16, L2_SETS, L2_ASSOC, false>, lru_policy> l2_level;
+        return std::unique_ptr<module>(new hierarchy<l1_level, l2_level, memory_level>(log, l1_level(l1), l2_level(*l2), memory_level(mem)));
+    }
+}
+
+std::unique_ptr<module> make_static_hierarchy(const sim_config& cfg, cache& l1, cache* l2, main_memory& mem, const logger& log)
+{
+    // shapes are only compiled for LRU
+    if (cfg.repl_policy != REPL_POLICY::LRU || (cfg.l2_size != 0 && l2 == nullptr)) {
+        return nullptr;
+    }
+
+    unsigned l1_sets = cfg.l1_size / (cfg.l1_block_size * cfg.l1_assoc);
+    unsigned l2_sets = cfg.l2_size != 0 ? cfg.l2_size / (16 * cfg.l2_assoc) : 0;
+    unsigned l2_assoc = cfg.l2_size != 0 ? cfg.l2_assoc : 0;
+
+#define CACHE_HIERARCHY_CASE(L1_BLOCKSIZE, L1_SETS, L1_ASSOC, L2_SETS, L2_ASSOC) \
+    if (cfg.l1_block_size == L1_BLOCKSIZE && l1_sets == L1_SETS && cfg.l1_assoc == L1_ASSOC && \
+        cfg.l1_size == L1_BLOCKSIZE * L1_SETS * L1_ASSOC && l2_sets == L2_SETS && l2_assoc == L2_ASSOC && \
+        (L2_SETS == 0 || cfg.l2_size == 16 * L2_SETS * L2_ASSOC)) { \
+        return cfg.vc_num_blocks > 0 \
+            ? build_hierarchy<static_geometry<L1_BLOCKSIZE, L1_SETS, L1_ASSOC, true>, L2_SETS, L2_ASSOC>(l1, l2, mem, log) \
+            : build_hierarchy<static_geometry<L1_BLOCKSIZE, L1_SETS, L1_ASSOC, false>, L2_SETS, L2_ASSOC>(l1, l2, mem, log); \
+    }
+
+    CACHE_HIERARCHY_SHAPES(CACHE_HIERARCHY_CASE)
+
+#undef CACHE_HIERARCHY_CASE
+
+    return nullptr;
+}
+
+uint64_t fast_forward(trace_reader& trace, uint64_t num, cache& l1, cache* l2, TRACE_STATUS& status)
+{
+    // records are decoded a batch at a time, each level runs the batch through before the next
+    std::vector<mem_req> batch(4096);
+    std::vector<mem_req> l1_next;
+    std::vector<mem_req> l2_next;
+
+    uint64_t done = 0;
+    status = TRACE_STATUS::VALID;
+
+    while (done < num && status == TRACE_STATUS::VALID)
+    {
+        size_t count = 0;
+        while (count < batch.size() && done + count < num && (status = trace.next(batch[count])) == TRACE_STATUS::VALID) {
+            count++;
+        }
+
+        l1_next.clear();
+        l1.warm(batch.data(), count, l1_next);
+
+        // memory keeps no state, what L2 sends on is dropped
+        if (l2 != nullptr)
+        {
+            l2_next.clear();
+            l2->warm(l1_next.data(), l1_next.size(), l2_next);
+        }
+
+        done += count;
+    }
+
+    return done;
+}
@@ -0,0 +1,179 @@
+/**
+ * @file hierarchy.h
+ * @details This file contains a hierarchy of levels composed at compile time
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef HIERARCHY_H
+#define HIERARCHY_H
+
+// standard includes
+#include <tuple>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include <cstddef>
+
+// local includes
+#include <module.h>
+#include <cache.h>
+#include <cache_access.h>
+#include <main_memory.h>
+#include <sweep.h>
+#include <trace_reader.h>
+
+/**
+ * @details A cache as a level of a static hierarchy, with its geometry and replacement policy
+ * fixed at compile time
+ */
+template <typename GEOM, typename POLICY>
+class cache_level
+{
+    private:
+        cache* _cache;
+        GEOM _geom;
+        POLICY* _repl;
+
+    public:
+
+        /**
+         * @details Level simulating c, whose replacement policy must be POLICY
+         */
+        cache_level(cache& c) : _cache(&c), _repl(&std::get<POLICY>(c.get_repl_policy()))
+        {
+            c.set_static_level(true);
+
+            if constexpr (std::is_same_v<GEOM, dynamic_geometry>) {
+                _geom = c.get_geometry();
+            }
+        }
+
+        const access_result& access(const mem_req& req) {
+            return _cache->lookup(_geom, *_repl, req);
+        }
+
+        /**
+         * @details Look up a batch, appending what it sends on to next. The static hierarchies send
+         * one request at a time, this serves a level run on its own, as the shared L2 of multicore_sim
+         */
+        void access_batch(const mem_req* reqs, size_t num, std::vector<mem_req>& next) {
+            _cache->lookup_batch(_geom, *_repl, reqs, num, next);
+        }
+};
+
+/**
+ * @details Main memory as the last level of a static hierarchy, every access hits
+ */
+class memory_level
+{
+    private:
+        main_memory* _mem;
+
+    public:
+        memory_level(main_memory& mem) : _mem(&mem) {}
+
+        access_result access(const mem_req& req)
+        {
+            _mem->mem_access = _mem->mem_access + 1;
+
+            access_result res;
+            res.hit = true;
+            return res;
+        }
+};
+
+/**
+ * @details Hierarchy of levels known at compile time, from the core to memory, for example
+ * hierarchy<cache_level<L1 geometry, lru_policy>, cache_level<L2 geometry, lru_policy>, memory_level>.
+ * Each level returns what it sends on, which is handed to the next level right away, so the whole
+ * chain is plain calls the compiler can inline instead of virtual hops through the module ports.
+ * It sits behind the core as a single module; the levels are not connected to each other. It is
+ * only built for requests sent one at a time, a batch is taken a request at a time as by any module
+ */
+template <typename... LEVELS>
+class hierarchy : public module
+{
+    private:
+        std::tuple<LEVELS...> _levels;
+
+        /**
+         * @details Simulate req at level LEVEL and whatever it sends on at the levels below
+         */
+        template <size_t LEVEL>
+        void send(const mem_req& req)
+        {
+            const access_result& res = std::get<LEVEL>(_levels).access(req);
+
+            // only a miss sends anything on
+            if constexpr (LEVEL + 1 < sizeof...(LEVELS))
+            {
+                if (res.hit) {
+                    return;
+                }
+
+                // a writeback always goes out before the fetch
+                if (res.evicted) {
+                    send<LEVEL + 1>(mem_req(OP_TYPE::STORE, res.evict_addr));
+                }
+                if (res.filled) {
+                    send<LEVEL + 1>(mem_req(OP_TYPE::LOAD, res.fill_addr));
+                }
+            }
+        }
+
+    public:
+
+        /**
+         * @details Construct from the levels, closest to the core first
+         */
+        hierarchy(const logger& log, const LEVELS&... levels) : module("Hierarchy", log), _levels(levels...) {}
+
+        /**
+         * @details Simulate a request through every level and respond right away
+         */
+        void get_frm_prev()
+        {
+            if (ifc_prev != nullptr)
+            {
+                send<0>(*req_ptr_prev);
+
+                resp_msg resp(true, req_ptr_prev->addr);
+                resp_ptr_prev = &resp;
+
+                put_to_prev(resp_ptr_prev);
+
+                // the response only lives for this call
+                resp_ptr_prev = nullptr;
+            }
+        }
+};
+
+/**
+ * @details Hierarchy shapes compiled as a static hierarchy with LRU replacement, as
+ * X(L1 block size, L1 sets, L1 associativity, L2 sets, L2 associativity). L2 blocks are 16 bytes,
+ * 0 L2 sets is a hierarchy without L2. Each entry is instantiated with and without a victim cache
+ */
+#define CACHE_HIERARCHY_SHAPES(X) \
+    X(16, 64, 1, 0, 0)      \
+    X(16, 32, 2, 0, 0)      \
+    X(16, 16, 4, 0, 0)      \
+    X(16, 64, 1, 128, 4)    \
+    X(16, 32, 2, 128, 4)    \
+    X(16, 16, 4, 128, 4)    \
+    X(16, 64, 2, 512, 8)    \
+    X(16, 128, 4, 1024, 8)
+
+/**
+ * @details Build the static hierarchy of cfg over the given caches and memory, nullptr if cfg is
+ * not one of the compiled shapes. l2 is nullptr without L2
+ */
+std::unique_ptr<module> make_static_hierarchy(const sim_config& cfg, cache& l1, cache* l2, main_memory& mem, const logger& log);
+
+/**
+ * @details Fast-forward l1 and l2 through the next num records of trace, updating line and replacement
+ * states only, see cache::warm. l2 is nullptr without L2. Returns the number of records read, fewer
+ * than num if the trace ended or held an invalid record, as status tells
+ */
+uint64_t fast_forward(trace_reader& trace, uint64_t num, cache& l1, cache* l2, TRACE_STATUS& status);
+
+#endif // HIERARCHY_H
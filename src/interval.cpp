@@ -0,0 +1,220 @@
+/**
+ * @file interval.cpp
+ * @details This file contains definitions for the interval sampler
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "interval.h"
+
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+
+// progress lines are printed at most this often, and for the last sample
+static const std::chrono::seconds PROGRESS_PERIOD(1);
+
+// how long the writer sleeps on an empty ring, samples are rare
+static const std::chrono::milliseconds WRITER_POLL(10);
+
+interval_sampler::interval_sampler(const std::string& path, uint64_t interval, bool is_progress_on, size_t ring_samples) :
+    base("Interval sampler"),
+    _interval(interval > 0 ? interval : 1),
+    _is_progress_on(is_progress_on),
+    _mem_traffic(nullptr),
+    _ring(ring_samples),
+    _is_running(false),
+    _total(0),
+    _first_done(0),
+    _last_done(0)
+{
+    if (!path.empty()) {
+        _stream.open(path, std::ios::trunc);
+    }
+    _stream << std::fixed;
+}
+
+bool interval_sampler::is_open() const
+{
+    return _stream.is_open() || !_stream.fail();
+}
+
+void interval_sampler::add_level(const std::string& name, const perf_counters::cache_counters* counters)
+{
+    _names.push_back(name);
+    _levels.push_back(counters);
+}
+
+void interval_sampler::begin(uint64_t accesses, uint64_t done, uint64_t total)
+{
+    if (_is_running) {
+        return;
+    }
+
+    if (_stream.is_open())
+    {
+        _stream << "interval,end_access,seconds";
+        for (const std::string& name : _names)
+        {
+            std::string prefix = "," + name + "_";
+            _stream << prefix << "reads" << prefix << "read_misses" << prefix << "writes" << prefix << "write_misses"
+                    << prefix << "swap_requests" << prefix << "swaps" << prefix << "writebacks" << prefix << "miss_rate";
+        }
+        _stream << ",mem_traffic\n";
+    }
+
+    _start = std::chrono::steady_clock::now();
+    _total = total;
+    _first_done = done;
+    _last_done = done;
+
+    _is_running = true;
+    _writer = std::thread(&interval_sampler::write_out, this);
+
+    // the first sample is the baseline the first interval is taken against
+    push(accesses, done, false);
+}
+
+void interval_sampler::push(uint64_t accesses, uint64_t done, bool is_last)
+{
+    interval_sample* slot = _ring.produce();
+
+    slot->accesses = accesses;
+    slot->done = done;
+    slot->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - _start).count();
+    slot->is_last = is_last;
+
+    // slots keep their buffer, only the first pass through the ring allocates
+    slot->values.resize(_levels.size() * NUM_FIELDS + 1);
+    uint64_t* val = slot->values.data();
+    for (const perf_counters::cache_counters* c : _levels)
+    {
+        *val++ = c->num_reads;
+        *val++ = c->read_misses;
+        *val++ = c->num_writes;
+        *val++ = c->write_misses;
+        *val++ = c->num_swap_req;
+        *val++ = c->num_swaps;
+        *val++ = c->num_writebacks;
+    }
+    *val = _mem_traffic != nullptr ? *_mem_traffic : 0;
+
+    _ring.commit();
+}
+
+void interval_sampler::write_out()
+{
+    std::vector<uint64_t> prev;
+    uint64_t prev_accesses = 0;
+    uint64_t first_accesses = 0;
+    bool is_first = true;
+    uint64_t num_intervals = 0;
+    std::chrono::steady_clock::time_point last_print;
+
+    while (true)
+    {
+        interval_sample* sample = _ring.try_consume();
+        if (sample == nullptr)
+        {
+            std::this_thread::sleep_for(WRITER_POLL);
+            continue;
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        bool is_baseline = is_first;
+
+        if (is_first)
+        {
+            first_accesses = sample->accesses;
+            last_print = now;
+            is_first = false;
+        }
+        else if (sample->accesses > prev_accesses && _stream.is_open())
+        {
+            _stream << num_intervals << "," << sample->accesses << "," << std::setprecision(6) << sample->seconds;
+            num_intervals++;
+
+            for (size_t lvl = 0; lvl < _levels.size(); lvl++)
+            {
+                uint64_t delta[NUM_FIELDS];
+                for (unsigned f = 0; f < NUM_FIELDS; f++)
+                {
+                    size_t idx = lvl * NUM_FIELDS + f;
+                    delta[f] = sample->values[idx] - prev[idx];
+                    _stream << "," << delta[f];
+                }
+
+                uint64_t accesses = delta[0] + delta[2];
+                _stream << ",";
+                if (accesses > 0) {
+                    _stream << std::setprecision(6) << (delta[1] + delta[3]) / (double) accesses;
+                }
+            }
+            _stream << "," << sample->values.back() - prev.back() << "\n";
+        }
+
+        if (_is_progress_on && !is_baseline && (sample->is_last || now - last_print >= PROGRESS_PERIOD))
+        {
+            print_progress(*sample, first_accesses);
+            last_print = now;
+        }
+
+        // the slot gets the old snapshot back, of the same size
+        prev.swap(sample->values);
+        prev_accesses = sample->accesses;
+
+        bool is_last = sample->is_last;
+        sample->is_last = false;
+        _ring.release();
+
+        if (is_last) {
+            return;
+        }
+    }
+}
+
+void interval_sampler::print_progress(const interval_sample& sample, uint64_t first_accesses) const
+{
+    std::ostringstream line;
+    line << std::fixed << std::setprecision(1);
+    line << "Progress: " << (_total > 0 ? 100.0 * sample.done / _total : 100.0) << "% of trace, "
+         << sample.accesses << " accesses, ";
+
+    double rate = sample.seconds > 0.0 ? (sample.accesses - first_accesses) / sample.seconds : 0.0;
+    line << std::setprecision(2) << rate / 1e6 << " M accesses/s, ";
+
+    if (sample.is_last) {
+        line << "done in " << sample.seconds << " s";
+    }
+    else if (sample.done > _first_done && _total >= sample.done) {
+        line << "ETA " << sample.seconds * (_total - sample.done) / (sample.done - _first_done) << " s";
+    }
+    else {
+        line << "ETA unknown";
+    }
+
+    std::cerr << line.str() << std::endl;
+}
+
+void interval_sampler::finish(uint64_t accesses)
+{
+    if (!_is_running) {
+        return;
+    }
+
+    push(accesses, _last_done, true);
+    _writer.join();
+    _is_running = false;
+
+    if (_stream.is_open()) {
+        _stream.close();
+    }
+}
+
+interval_sampler::~interval_sampler()
+{
+    if (_is_running)
+    {
+        push(0, _last_done, true);
+        _writer.join();
+    }
+}
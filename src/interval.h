@@ -0,0 +1,164 @@
+/**
+ * @file interval.h
+ * @details This file contains the interval sampler of long runs
+ *
+ * Every interval of accesses the simulating thread copies the counters of every level into a slot of
+ * a ring. A background thread turns consecutive snapshots into per interval deltas, written as one CSV
+ * line per interval:
+ *
+ *      interval,end_access,seconds,<level>_reads,<level>_read_misses,...,<level>_miss_rate,...,mem_traffic
+ *
+ * and, when asked, prints progress lines with the access rate, the share of the trace consumed and the
+ * time left.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef INTERVAL_H
+#define INTERVAL_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+
+// local includes
+#include <base.h>
+#include <perf_counters.h>
+#include <spsc_ring.h>
+
+/**
+ * @details Counters of every level at the end of an interval, as the simulating thread saw them
+ */
+struct interval_sample
+{
+    // accesses issued and trace consumed, in bytes or records, when it was taken
+    uint64_t accesses;
+    uint64_t done;
+    double seconds;
+
+    // NUM_FIELDS counters per level, closest to the core first, then memory traffic
+    std::vector<uint64_t> values;
+
+    // set on the sample that stops the writer
+    bool is_last;
+
+    interval_sample() : accesses(0), done(0), seconds(0.0), is_last(false) {}
+};
+
+/**
+ * @details Samples the counters of a hierarchy every interval of accesses and writes them out on a
+ * background thread. The simulating thread only compares its access count against the next boundary
+ * and copies the counters once per interval
+ */
+class interval_sampler : public base
+{
+    public:
+        // counters of a level in a sample, in cache_counters order
+        static const unsigned NUM_FIELDS = 7;
+
+    private:
+        uint64_t _interval;
+        bool _is_progress_on;
+
+        // time series, not open without one
+        std::ofstream _stream;
+
+        std::vector<std::string> _names;
+        std::vector<const perf_counters::cache_counters*> _levels;
+        const uint64_t* _mem_traffic;
+
+        spsc_ring<interval_sample> _ring;
+        std::thread _writer;
+        bool _is_running;
+
+        std::chrono::steady_clock::time_point _start;
+
+        // size of the trace in the unit of done, and where it stood at the first sample
+        uint64_t _total;
+        uint64_t _first_done;
+
+        // trace consumed by the end of the run
+        uint64_t _last_done;
+
+        /**
+         * @details Copy the counters into the next slot and hand it to the writer
+         */
+        void push(uint64_t accesses, uint64_t done, bool is_last);
+
+        /**
+         * @details Writer thread, writes samples until the last one
+         */
+        void write_out();
+
+        /**
+         * @details Print a progress line for a sample
+         */
+        void print_progress(const interval_sample& sample, uint64_t first_accesses) const;
+
+    public:
+
+        /**
+         * @details Sampler taking a sample every interval accesses, writing the time series to path
+         * unless it is empty and printing progress when is_progress_on
+         */
+        interval_sampler(const std::string& path, uint64_t interval, bool is_progress_on, size_t ring_samples = 64);
+
+        interval_sampler(const interval_sampler&) = delete;
+        interval_sampler& operator=(const interval_sampler&) = delete;
+
+        /**
+         * @details Check that the time series could be created, always true without one
+         */
+        bool is_open() const;
+
+        /**
+         * @details Sample the counters of a level, levels are added closest to the core first
+         */
+        void add_level(const std::string& name, const perf_counters::cache_counters* counters);
+
+        /**
+         * @details Sample memory traffic as well
+         */
+        void set_mem_traffic(const uint64_t* mem_traffic) {
+            _mem_traffic = mem_traffic;
+        }
+
+        uint64_t get_interval() const {
+            return _interval;
+        }
+
+        /**
+         * @details Start sampling with the counters as they are after accesses accesses, done of total
+         * consumed. Calls once sampling started are ignored
+         */
+        void begin(uint64_t accesses, uint64_t done, uint64_t total);
+
+        /**
+         * @details Take the sample ending an interval after accesses accesses, done consumed
+         */
+        void sample(uint64_t accesses, uint64_t done) {
+            push(accesses, done, false);
+        }
+
+        /**
+         * @details Note how much of the trace was consumed when the simulating thread stopped
+         */
+        void set_done(uint64_t done) {
+            _last_done = done;
+        }
+
+        /**
+         * @details Take the sample ending the last, partial interval and wait for everything to be written
+         */
+        void finish(uint64_t accesses);
+
+        /**
+         * @details destructor stopping the writer if still running
+         */
+        ~interval_sampler();
+};
+
+#endif // INTERVAL_H
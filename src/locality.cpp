@@ -0,0 +1,163 @@
+/**
+ * @file locality.cpp
+ * @details This file contains definitions of the locality profile and its probe
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "locality.h"
+
+#include <cstdio>
+
+/**
+ * @details Power of two bin of a count of at least 1, bin b holds 2^b to 2^(b+1) - 1
+ */
+static inline unsigned log2_bin(uint64_t count)
+{
+    return 63 - __builtin_clzll(count);
+}
+
+locality_profile::locality_profile(const std::string& name, unsigned block_bits) :
+    base(name),
+    _block_bits(block_bits),
+    _accesses(0),
+    _dist_hist(),
+    _reuse_count(),
+    _reuse_sum(),
+    _first_count(),
+    _first_sum()
+{
+}
+
+void locality_profile::access(unsigned addr)
+{
+    bool is_new;
+    uint32_t id = _ids.find_or_add(addr >> _block_bits, is_new);
+
+    // times count from 1
+    uint64_t now = ++_accesses;
+
+    if (is_new)
+    {
+        _slot_of.push_back(0);
+        _last_access.push_back(now);
+
+        unsigned bin = log2_bin(now);
+        _first_count[bin]++;
+        _first_sum[bin] += now;
+    }
+    else
+    {
+        uint64_t reuse_time = now - _last_access[id];
+        _last_access[id] = now;
+
+        unsigned bin = log2_bin(reuse_time);
+        _reuse_count[bin]++;
+        _reuse_sum[bin] += reuse_time;
+    }
+
+    uint32_t distance = _stack.touch(id, _slot_of);
+    if (distance != lru_stack::COLD) {
+        _dist_hist[distance == 0 ? 0 : log2_bin(distance) + 1]++;
+    }
+}
+
+uint64_t locality_profile::get_lru_misses(unsigned size_bits) const
+{
+    // an access hits if fewer distinct blocks than the cache holds were accessed since its block
+    uint64_t misses = _ids.size();
+    for (unsigned bin = size_bits + 1; bin < NUM_BINS; bin++) {
+        misses += _dist_hist[bin];
+    }
+    return misses;
+}
+
+uint64_t locality_profile::excess(const uint64_t count[NUM_BINS], const uint64_t sum[NUM_BINS], uint64_t window)
+{
+    // times of the bins from the window's own on are all at least the window
+    uint64_t total = 0;
+    for (unsigned bin = log2_bin(window); bin < NUM_BINS; bin++) {
+        total += sum[bin] - window * count[bin];
+    }
+    return total;
+}
+
+double locality_profile::get_working_set(unsigned window_bits) const
+{
+    uint64_t window = 1ull << window_bits;
+    if (window > _accesses) {
+        return 0.0;
+    }
+
+    // windows falling between two accesses to a block, before its first or after its last lack it
+    uint64_t missing = excess(_reuse_count, _reuse_sum, window) + excess(_first_count, _first_sum, window);
+    for (uint64_t last : _last_access)
+    {
+        uint64_t after = _accesses - last + 1;
+        if (after > window) {
+            missing += after - window;
+        }
+    }
+
+    return _ids.size() - missing / (double) (_accesses - window + 1);
+}
+
+// locality_probe
+
+locality_probe::locality_probe(locality_profile& profile, const std::string& name, const logger& log) :
+    module(name + " locality probe", log),
+    _profile(&profile)
+{
+}
+
+void locality_probe::get_frm_prev()
+{
+    if (ifc_prev != nullptr)
+    {
+        _profile->access(req_ptr_prev->addr);
+        put_to_next(req_ptr_prev);
+    }
+}
+
+void locality_probe::get_frm_next()
+{
+    if (ifc_prev != nullptr) {
+        put_to_prev(resp_ptr_next);
+    }
+}
+
+void locality_probe::get_batch_frm_prev(mem_req* reqs, size_t num)
+{
+    for (size_t i = 0; i < num; i++) {
+        _profile->access(reqs[i].addr);
+    }
+    put_batch_to_next(reqs, num);
+}
+
+bool write_locality_csv(const std::string& path, const std::vector<locality_profile*>& profiles)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    fputs("stream,k,distance_min,distance_max,reuses,lru_miss_rate,working_set\n", file);
+
+    for (locality_profile* profile : profiles)
+    {
+        uint64_t accesses = profile->get_accesses();
+        if (accesses == 0) {
+            continue;
+        }
+
+        for (unsigned k = 0; k < 64 && (1ull << k) <= accesses; k++)
+        {
+            uint64_t distance_min = k == 0 ? 0 : 1ull << (k - 1);
+            uint64_t distance_max = (1ull << k) - 1;
+
+            fprintf(file, "%s,%u,%lu,%lu,%lu,%.6f,%.3f\n", profile->get_name().c_str(), k, distance_min, distance_max,
+                    profile->get_reuses(k), profile->get_lru_misses(k) / (double) accesses, profile->get_working_set(k));
+        }
+    }
+
+    return fclose(file) == 0;
+}
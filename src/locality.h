@@ -0,0 +1,139 @@
+/**
+ * @file locality.h
+ * @details This file contains the locality profile of a request stream and the probe feeding it
+ *
+ * The reuse distance of an access is the number of distinct other blocks accessed since the previous
+ * access to its block, found in O(log n) on the Fenwick tree of an LRU stack. Its histogram gives the
+ * misses of a fully associative LRU cache of any size. The working set of a window is the number of
+ * distinct blocks accessed in it; its average over every window of w accesses follows from histograms
+ * of reuse times and first access times and the time of the last access to every block:
+ *
+ *      ws(w) = m - (sum (t - w)+ over reuse times t + sum (f - w)+ over first access times f
+ *                   + sum (n - l + 1 - w)+ over last access times l) / (n - w + 1)
+ *
+ * for n accesses to m blocks, times counted from 1. Both are kept in power of two bins, which makes
+ * them exact for power of two cache sizes and windows. Memory grows with the number of distinct
+ * blocks only, the LRU stack renumbers its time line once it is used up.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef LOCALITY_H
+#define LOCALITY_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// local includes
+#include <module.h>
+#include <block_ids.h>
+#include <stack_distance.h>
+
+/**
+ * @details Reuse distance and working set profile of the blocks of one request stream
+ */
+class locality_profile : public base
+{
+    public:
+        // power of two bins, enough for any 64-bit count
+        static constexpr unsigned NUM_BINS = 65;
+
+    private:
+        unsigned _block_bits;
+
+        // dense ids of the blocks, LRU stack over them and the slot plus one of every id on it
+        block_id_table _ids;
+        lru_stack _stack;
+        std::vector<uint32_t> _slot_of;
+
+        // time of the last access to every id
+        std::vector<uint64_t> _last_access;
+
+        uint64_t _accesses;
+
+        // reuse distances, bin 0 holds distance 0 and bin b distances 2^(b-1) to 2^b - 1
+        uint64_t _dist_hist[NUM_BINS];
+
+        // counts and sums of reuse times and first access times, bin b holds 2^b to 2^(b+1) - 1
+        uint64_t _reuse_count[NUM_BINS];
+        uint64_t _reuse_sum[NUM_BINS];
+        uint64_t _first_count[NUM_BINS];
+        uint64_t _first_sum[NUM_BINS];
+
+        /**
+         * @details Sum of (t - window)+ over the times binned in count and sum
+         */
+        static uint64_t excess(const uint64_t count[NUM_BINS], const uint64_t sum[NUM_BINS], uint64_t window);
+
+    public:
+
+        /**
+         * @details Profile of the stream named name in blocks of 2^block_bits bytes
+         */
+        locality_profile(const std::string& name, unsigned block_bits);
+
+        /**
+         * @details Account an access to addr
+         */
+        void access(unsigned addr);
+
+        uint64_t get_accesses() const {
+            return _accesses;
+        }
+
+        /**
+         * @details Number of distinct blocks accessed
+         */
+        uint64_t get_blocks() const {
+            return _ids.size();
+        }
+
+        /**
+         * @details Accesses of reuse distance bin, bin 0 is distance 0 and bin b distances 2^(b-1) to 2^b - 1
+         */
+        uint64_t get_reuses(unsigned bin) const {
+            return _dist_hist[bin];
+        }
+
+        /**
+         * @details Misses of a fully associative LRU cache of 2^size_bits blocks
+         */
+        uint64_t get_lru_misses(unsigned size_bits) const;
+
+        /**
+         * @details Average working set in blocks over every window of 2^window_bits accesses, 0 if there
+         * are fewer accesses
+         */
+        double get_working_set(unsigned window_bits) const;
+};
+
+/**
+ * @details Sits in front of a module and profiles the requests it receives
+ */
+class locality_probe : public module
+{
+    private:
+        locality_profile* _profile;
+
+    public:
+
+        /**
+         * @details Probe in front of the module named name feeding profile
+         */
+        locality_probe(locality_profile& profile, const std::string& name, const logger& log);
+
+        void get_frm_prev();
+        void get_frm_next();
+        void get_batch_frm_prev(mem_req* reqs, size_t num);
+};
+
+/**
+ * @details Write every profile to path as CSV lines of "stream,k,distance_min,distance_max,reuses,
+ * lru_miss_rate,working_set" for k from 0 up to the largest power of two window the stream fills:
+ * accesses of reuse distance bin k, miss rate of a fully associative LRU cache of 2^k blocks and average
+ * working set over windows of 2^k accesses. False if it could not be written
+ */
+bool write_locality_csv(const std::string& path, const std::vector<locality_profile*>& profiles);
+
+#endif // LOCALITY_H
@@ -0,0 +1,136 @@
+/**
+ * @file log_decode.cpp
+ * @details Decoder printing a binary DEBUG event log as the console would have
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include <iostream>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include <cstring>
+
+#include <common.h>
+#include <log_sink.h>
+#include <trace_bin.h>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "usage: " << argv[0] << " <event log>" << std::endl;
+        return 1;
+    }
+
+    std::string path = argv[1];
+
+    logger log(verbose::INFO);
+    base decoder("Log decoder");
+
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open())
+    {
+        log.log(&decoder, verbose::FATAL, path + ": Unable to find file");
+        return 1;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    log_events::header hdr;
+    if (data.size() >= sizeof(hdr)) {
+        std::memcpy(&hdr, data.data(), sizeof(hdr));
+    }
+    if (data.size() < sizeof(hdr) || std::memcmp(hdr.magic, log_events::MAGIC, sizeof(hdr.magic)) != 0 ||
+        hdr.version != log_events::VERSION)
+    {
+        log.log(&decoder, verbose::FATAL, path + ": Not an event log");
+        return 1;
+    }
+
+    const uint8_t* p = data.data() + sizeof(hdr);
+    const uint8_t* end = data.data() + data.size();
+
+    std::vector<std::string> strings;
+    std::string msg;
+    uint64_t num_events = 0;
+
+    while (p != end)
+    {
+        uint8_t type = *p++;
+
+        if (type == log_events::STRING)
+        {
+            uint64_t id, len;
+            if ((p = bin_trace::get_varint(p, end, id)) == nullptr || (p = bin_trace::get_varint(p, end, len)) == nullptr ||
+                id != strings.size() || (uint64_t) (end - p) < len) {
+                break;
+            }
+            strings.emplace_back(reinterpret_cast<const char*>(p), len);
+            p += len;
+        }
+        else if (type == log_events::EVENT)
+        {
+            if (end - p < 3) {
+                p = nullptr;
+                break;
+            }
+            verbose level = (verbose) p[0];
+            size_t num_args = p[1];
+            uint8_t str_mask = p[2];
+            p += 3;
+
+            uint64_t src_id, fmt_id;
+            if (num_args > LOG_MAX_ARGS || (p = bin_trace::get_varint(p, end, src_id)) == nullptr ||
+                (p = bin_trace::get_varint(p, end, fmt_id)) == nullptr || src_id >= strings.size() || fmt_id >= strings.size()) {
+                p = nullptr;
+                break;
+            }
+
+            log_arg args[LOG_MAX_ARGS] = {0, 0, 0, 0, 0, 0, 0, 0};
+            for (size_t i = 0; i < num_args && p != nullptr; i++)
+            {
+                uint64_t val;
+                if ((p = bin_trace::get_varint(p, end, val)) == nullptr) {
+                    break;
+                }
+
+                if ((str_mask >> i) & 1)
+                {
+                    if (val >= strings.size()) {
+                        p = nullptr;
+                        break;
+                    }
+                    args[i] = log_arg(strings[val]);
+                }
+                else {
+                    args[i].val = val;
+                }
+            }
+            if (p == nullptr) {
+                break;
+            }
+
+            msg.clear();
+            format_log(msg, strings[fmt_id].c_str(), args, num_args);
+            std::cout << log_lvl_str(level) << ": " << strings[src_id] << " :: " << msg << "\n";
+
+            num_events++;
+        }
+        else
+        {
+            p = nullptr;
+            break;
+        }
+    }
+
+    std::cout.flush();
+
+    if (p != end)
+    {
+        log.log(&decoder, verbose::FATAL, path + ": Corrupt event log after " + std::to_string(num_events) + " events");
+        return 1;
+    }
+
+    return 0;
+}
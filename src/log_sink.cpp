@@ -0,0 +1,149 @@
+/**
+ * @file log_sink.cpp
+ * @details This file contains definitions for the binary log event writer
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "log_sink.h"
+
+#include <cstring>
+
+#include <trace_bin.h>
+
+// chunks are handed to the writer once they grow past this
+static const size_t CHUNK_BYTES = 1 << 16;
+
+bin_log_sink::bin_log_sink(const std::string& path, size_t ring_chunks) :
+    base("Log event sink"),
+    _stream(path, std::ios::binary | std::ios::trunc),
+    _ring(ring_chunks),
+    _is_running(false),
+    _num_events(0),
+    _num_bytes(0)
+{
+    if (!_stream.is_open()) {
+        return;
+    }
+
+    log_events::header hdr;
+    std::memset(&hdr, 0, sizeof(hdr));
+    std::memcpy(hdr.magic, log_events::MAGIC, sizeof(hdr.magic));
+    hdr.version = log_events::VERSION;
+
+    _stream.write(reinterpret_cast<const char*>(&hdr), sizeof(hdr));
+    _num_bytes = sizeof(hdr);
+
+    _chunk.reserve(CHUNK_BYTES + 256);
+
+    _is_running = true;
+    _writer = std::thread(&bin_log_sink::write_out, this);
+}
+
+uint32_t bin_log_sink::intern(std::string_view str)
+{
+    auto it = _ids.find(str);
+    if (it != _ids.end()) {
+        return it->second;
+    }
+
+    uint32_t id = _strings.size();
+    _strings.emplace_back(str);
+    _ids.emplace(_strings.back(), id);
+
+    _chunk.push_back(log_events::STRING);
+    bin_trace::put_varint(_chunk, id);
+    bin_trace::put_varint(_chunk, str.size());
+    _chunk.insert(_chunk.end(), str.begin(), str.end());
+
+    return id;
+}
+
+void bin_log_sink::record(base* base_ptr, verbose level, const char* fmt, const log_arg* args, size_t num_args)
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (!_is_running) {
+        return;
+    }
+
+    // strings go out before the event using them
+    uint32_t src_id = intern(base_ptr->get_name());
+    uint32_t fmt_id = intern(fmt);
+
+    uint8_t str_mask = 0;
+    uint32_t str_ids[LOG_MAX_ARGS];
+    for (size_t i = 0; i < num_args; i++)
+    {
+        if (args[i].str != nullptr)
+        {
+            str_mask |= 1 << i;
+            str_ids[i] = intern(args[i].str);
+        }
+    }
+
+    _chunk.push_back(log_events::EVENT);
+    _chunk.push_back(level);
+    _chunk.push_back(num_args);
+    _chunk.push_back(str_mask);
+    bin_trace::put_varint(_chunk, src_id);
+    bin_trace::put_varint(_chunk, fmt_id);
+    for (size_t i = 0; i < num_args; i++) {
+        bin_trace::put_varint(_chunk, (str_mask >> i) & 1 ? str_ids[i] : args[i].val);
+    }
+
+    _num_events++;
+
+    if (_chunk.size() >= CHUNK_BYTES) {
+        flush_chunk(false);
+    }
+}
+
+void bin_log_sink::flush_chunk(bool is_last)
+{
+    // the slot gets the filled buffer and hands back one the writer is done with
+    log_chunk* chunk = _ring.produce();
+    chunk->bytes.swap(_chunk);
+    chunk->is_last = is_last;
+    _ring.commit();
+
+    _chunk.clear();
+}
+
+void bin_log_sink::write_out()
+{
+    while (true)
+    {
+        log_chunk* chunk = _ring.consume();
+
+        _stream.write(reinterpret_cast<const char*>(chunk->bytes.data()), chunk->bytes.size());
+        _num_bytes += chunk->bytes.size();
+
+        bool is_last = chunk->is_last;
+        chunk->is_last = false;
+        _ring.release();
+
+        if (is_last) {
+            return;
+        }
+    }
+}
+
+void bin_log_sink::close()
+{
+    std::lock_guard<std::mutex> guard(_lock);
+
+    if (!_is_running) {
+        return;
+    }
+
+    flush_chunk(true);
+    _writer.join();
+    _is_running = false;
+
+    _stream.close();
+}
+
+bin_log_sink::~bin_log_sink()
+{
+    close();
+}
@@ -0,0 +1,150 @@
+/**
+ * @file log_sink.h
+ * @details This file contains the binary log event format and its asynchronous writer
+ *
+ * An event log is a log_events::header followed by records, each starting with its type byte:
+ *
+ *      STRING: varint id, varint length, bytes
+ *      EVENT:  level, number of arguments, string argument mask, varint source id, varint format id,
+ *              one varint per argument
+ *
+ * Module names, formats and string arguments are written once as STRING records and referred to by
+ * id afterwards. Bit i of the mask is set when argument i is a string id instead of an integer.
+ * log_decode prints an event log exactly as the console would have.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef LOG_SINK_H
+#define LOG_SINK_H
+
+// standard includes
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <cstdint>
+
+// local includes
+#include <common.h>
+#include <spsc_ring.h>
+
+namespace log_events
+{
+    const char MAGIC[8] = {'C', 'S', 'I', 'M', 'L', 'O', 'G', '\0'};
+    const uint16_t VERSION = 1;
+
+    // record types
+    const uint8_t STRING = 1;
+    const uint8_t EVENT = 2;
+
+    /**
+     * @details File header
+     */
+    struct header
+    {
+        char magic[8];
+        uint16_t version;
+        uint16_t reserved[3];
+    };
+}
+
+/**
+ * @details Chunk of encoded records in flight to the writer thread
+ */
+struct log_chunk
+{
+    std::vector<uint8_t> bytes;
+
+    // set on the chunk that stops the writer
+    bool is_last;
+
+    log_chunk() : is_last(false) {}
+};
+
+/**
+ * @details Records DEBUG messages as compact binary events instead of formatting them. Events are
+ * encoded into a chunk on the logging thread and written out by a background thread, so a DEBUG
+ * trace costs an encode per message instead of a format and a console write. Messages may come from
+ * several threads, they are serialized by a lock
+ */
+class bin_log_sink : public base, public log_event_sink
+{
+    private:
+        std::ofstream _stream;
+        std::mutex _lock;
+
+        // strings already written, keys point into _strings
+        std::unordered_map<std::string_view, uint32_t> _ids;
+        std::deque<std::string> _strings;
+
+        // chunk being filled
+        std::vector<uint8_t> _chunk;
+
+        spsc_ring<log_chunk> _ring;
+        std::thread _writer;
+        bool _is_running;
+
+        uint64_t _num_events;
+        uint64_t _num_bytes;
+
+        /**
+         * @details Id of str, writing a STRING record the first time it is seen
+         */
+        uint32_t intern(std::string_view str);
+
+        /**
+         * @details Hand the current chunk to the writer thread
+         */
+        void flush_chunk(bool is_last);
+
+        /**
+         * @details Writer thread, writes chunks until the last one
+         */
+        void write_out();
+
+    public:
+
+        /**
+         * @details Constructor that creates the event log at path
+         */
+        bin_log_sink(const std::string& path, size_t ring_chunks = 16);
+
+        bin_log_sink(const bin_log_sink&) = delete;
+        bin_log_sink& operator=(const bin_log_sink&) = delete;
+
+        /**
+         * @details Check if the output file could be created
+         */
+        bool is_open() const {
+            return _stream.is_open();
+        }
+
+        /**
+         * @details Encode one message
+         */
+        void record(base* base_ptr, verbose level, const char* fmt, const log_arg* args, size_t num_args);
+
+        /**
+         * @details Write out everything recorded so far and stop the writer thread
+         */
+        void close();
+
+        uint64_t get_num_events() const {
+            return _num_events;
+        }
+
+        uint64_t get_num_bytes() const {
+            return _num_bytes;
+        }
+
+        /**
+         * @details destructor closing the log if still open
+         */
+        ~bin_log_sink();
+};
+
+#endif // LOG_SINK_H
@@ -1,5 +1,8 @@
 #include <iostream>
 #include <iomanip>
+#include <memory>
+#include <chrono>
+#include <stdexcept>
 
 #include <cpu.h>
 #include <cache.h>
@@ -7,7 +10,28 @@
 #include <common.h>
 #include <perf_counters.h>
 
-#include <parse.h>
+#include <cacti_store.h>
+#include <sweep.h>
+#include <shard.h>
+#include <async_link.h>
+#include <alloc_count.h>
+#include <log_sink.h>
+#include <hierarchy.h>
+#include <checkpoint.h>
+#include <multicore.h>
+#include <profiler.h>
+#include <stats.h>
+#include <interval.h>
+#include <locality.h>
+
+/**
+ * @details Print how the simulator is run
+ */
+static void print_usage(const char* prog)
+{
+    std::cout << "usage: " << prog << " <L1_SIZE> <L1_ASSOC> <L1_BLOCKSIZE> <VC_NUM_BLOCKS> <L2_SIZE> <L2_ASSOC> <trace_file> [flags]" << std::endl;
+    std::cout << "       " << prog << " --sweep <grid file> <trace_file> [flags]" << std::endl;
+}
 
 int main(int argc, char* argv[]) 
 {
@@ -23,23 +47,366 @@ int main(int argc, char* argv[])
 
     std::string trace_file_path = "";
 
+    // sweep mode takes a grid file instead of one configuration
+    bool is_sweep = argc > 1 && std::string(argv[1]) == "--sweep";
+    std::string sweep_grid_path = "";
+    int first_flag = 8;
+
     // parse arguments
-    l1_cache_size = std::stoul(argv[1]);
-    l1_cache_assoc = std::stoul(argv[2]);
-    l1_cache_block_size = std::stoul(argv[3]);
-    l1_cache_num_victim_blocks = std::stoul(argv[4]);
+    if (argc < (is_sweep ? 4 : 8))
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (is_sweep)
+    {
+        sweep_grid_path = argv[2];
+        trace_file_path = argv[3];
+        first_flag = 4;
+    }
+    else
+    {
+        try
+        {
+            l1_cache_size = parse_number<unsigned>(argv[1]);
+            l1_cache_assoc = parse_number<unsigned>(argv[2]);
+            l1_cache_block_size = parse_number<unsigned>(argv[3]);
+            l1_cache_num_victim_blocks = parse_number<unsigned>(argv[4]);
+
+            l2_cache_size = parse_number<unsigned>(argv[5]);
+            l2_cache_assoc = parse_number<unsigned>(argv[6]);
+        }
+        catch (const std::logic_error&)
+        {
+            // std::invalid_argument and std::out_of_range
+            std::cout << "FATAL: cache sizes, associativities and victim blocks must be whole numbers" << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+
+        trace_file_path = argv[7];
+    }
+
+    // optional flags
+    bool is_pipelined = false;
+    size_t batch_size = 1024;
+    REPL_POLICY repl_policy = REPL_POLICY::LRU;
+    uint64_t repl_seed = 1;
+    unsigned num_threads = 0;
+    unsigned num_shards = 1;
+    bool is_async = false;
+    bool is_alloc_count_on = false;
+    bool is_debug_on = false;
+    bool is_dynamic = false;
+    std::string debug_events_path = "";
+    std::string cacti_store_path = "cacti_store.txt";
+    bool is_cacti_prefetch = false;
+    CACTI_MODE cacti_mode = CACTI_MODE::FALLBACK;
+    std::string cacti_table_path = "";
+    std::string checkpoint_path = "";
+    uint64_t checkpoint_at = 0;
+    std::string restore_path = "";
+    uint64_t ffwd_num = 0;
+    uint64_t ffwd_to = 0;
+    std::vector<std::string> core_trace_paths;
+    uint64_t quantum = 10000;
+    bool is_profile_on = false;
+    stats_paths stats_out;
+    uint64_t interval = 1000000;
+    std::string interval_path = "";
+    bool is_progress_on = false;
+    bool is_classify_on = false;
+    std::string locality_path = "";
+
+    // a flag whose number does not parse ends the run, arg names it
+    std::string arg;
+    try
+    {
+        for (int i = first_flag; i < argc; i++)
+        {
+            arg = argv[i];
+            if (arg == "--pipeline") {
+                is_pipelined = true;
+            }
+            else if (arg.rfind("--batch=", 0) == 0) {
+                batch_size = parse_number<size_t>(arg.substr(8));
+            }
+            else if (arg.rfind("--repl=", 0) == 0) {
+                if (!parse_repl_policy(arg.substr(7), repl_policy)) {
+                    std::cout << "WARN: unknown replacement policy " << arg.substr(7) << ", using lru" << std::endl;
+                }
+            }
+            else if (arg.rfind("--seed=", 0) == 0) {
+                repl_seed = parse_number<uint64_t>(arg.substr(7));
+            }
+            else if (arg.rfind("--threads=", 0) == 0) {
+                num_threads = parse_number<unsigned>(arg.substr(10));
+            }
+            else if (arg.rfind("--shards=", 0) == 0) {
+                num_shards = parse_number<unsigned>(arg.substr(9));
+            }
+            else if (arg == "--async") {
+                is_async = true;
+            }
+            else if (arg == "--count-allocs") {
+                is_alloc_count_on = true;
+            }
+            else if (arg == "--dynamic") {
+                is_dynamic = true;
+            }
+            else if (arg.rfind("--cacti-store=", 0) == 0) {
+                cacti_store_path = arg.substr(14);
+            }
+            else if (arg == "--cacti-prefetch") {
+                is_cacti_prefetch = true;
+            }
+            else if (arg.rfind("--cacti=", 0) == 0) {
+                if (!parse_cacti_mode(arg.substr(8), cacti_mode)) {
+                    std::cout << "WARN: unknown CACTI mode " << arg.substr(8) << ", using fallback" << std::endl;
+                }
+            }
+            else if (arg.rfind("--cacti-table=", 0) == 0) {
+                cacti_table_path = arg.substr(14);
+            }
+            else if (arg.rfind("--checkpoint=", 0) == 0) {
+                checkpoint_path = arg.substr(13);
+            }
+            else if (arg.rfind("--checkpoint-at=", 0) == 0) {
+                checkpoint_at = parse_number<uint64_t>(arg.substr(16));
+            }
+            else if (arg.rfind("--restore=", 0) == 0) {
+                restore_path = arg.substr(10);
+            }
+            else if (arg.rfind("--ffwd=", 0) == 0) {
+                ffwd_num = parse_number<uint64_t>(arg.substr(7));
+            }
+            else if (arg.rfind("--ffwd-to=", 0) == 0) {
+                ffwd_to = parse_number<uint64_t>(arg.substr(10));
+            }
+            else if (arg.rfind("--core-trace=", 0) == 0) {
+                core_trace_paths.push_back(arg.substr(13));
+            }
+            else if (arg.rfind("--quantum=", 0) == 0) {
+                quantum = parse_number<uint64_t>(arg.substr(10));
+                if (quantum > multicore_sim::MAX_QUANTUM)
+                {
+                    std::cout << "FATAL: --quantum is at most " << multicore_sim::MAX_QUANTUM << " records" << std::endl;
+                    return 1;
+                }
+            }
+            else if (arg == "--profile") {
+                is_profile_on = true;
+            }
+            else if (arg.rfind("--stats-json=", 0) == 0) {
+                stats_out.json = arg.substr(13);
+            }
+            else if (arg.rfind("--stats-csv=", 0) == 0) {
+                stats_out.csv = arg.substr(12);
+            }
+            else if (arg.rfind("--set-stats=", 0) == 0) {
+                stats_out.sets = arg.substr(12);
+            }
+            else if (arg.rfind("--interval=", 0) == 0) {
+                interval = parse_number<uint64_t>(arg.substr(11));
+            }
+            else if (arg.rfind("--interval-stats=", 0) == 0) {
+                interval_path = arg.substr(17);
+            }
+            else if (arg == "--progress") {
+                is_progress_on = true;
+            }
+            else if (arg == "--classify-misses") {
+                is_classify_on = true;
+            }
+            else if (arg.rfind("--locality=", 0) == 0) {
+                locality_path = arg.substr(11);
+            }
+            else if (arg == "--debug") {
+                is_debug_on = true;
+            }
+            else if (arg.rfind("--debug-events=", 0) == 0) {
+                debug_events_path = arg.substr(15);
+            }
+            else {
+                std::cout << "WARN: ignoring unknown option " << arg << std::endl;
+            }
+        }
+    }
+    catch (const std::logic_error&)
+    {
+        std::cout << "FATAL: " << arg << ": not a whole number in range" << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
 
-    l2_cache_size = std::stoul(argv[5]);
-    l2_cache_assoc = std::stoul(argv[6]);
+    sim_config cfg;
+    cfg.l1_size = l1_cache_size;
+    cfg.l1_assoc = l1_cache_assoc;
+    cfg.l1_block_size = l1_cache_block_size;
+    cfg.vc_num_blocks = l1_cache_num_victim_blocks;
+    cfg.l2_size = l2_cache_size;
+    cfg.l2_assoc = l2_cache_assoc;
+    cfg.repl_policy = repl_policy;
+    cfg.repl_seed = repl_seed;
+
+    // CACTI results shared with other runs through the store file, behind the table model
+    cacti_table cacti_model;
+    if (!cacti_table_path.empty() && !cacti_model.load(cacti_table_path))
+    {
+        std::cout << "FATAL: " << cacti_table_path << ": Unable to read CACTI table" << std::endl;
+        return 1;
+    }
+    cacti_store cacti(cacti_store_path, cacti_mode, &cacti_model);
+
+    if (is_sweep)
+    {
+        if (!stats_out.sets.empty())
+        {
+            std::cout << "WARN: per set counters are kept for a single run, ignoring --set-stats" << std::endl;
+            stats_out.sets.clear();
+        }
+        return run_sweep(sweep_grid_path, trace_file_path, cfg, num_threads, batch_size, cacti, is_cacti_prefetch, stats_out);
+    }
+
+    if (is_async && batch_size == 0)
+    {
+        std::cout << "WARN: levels only run on their own threads for batches, running synchronously" << std::endl;
+        is_async = false;
+    }
 
-    trace_file_path = argv[7];
+    if (num_shards > 1 && !sharded_sim::can_shard(cfg))
+    {
+        std::cout << "WARN: sharding needs a cache without victim cache and a replacement policy without shared state, running unsharded" << std::endl;
+        num_shards = 1;
+    }
+
+    bool is_checkpoint_on = !checkpoint_path.empty() || !restore_path.empty();
+    if (is_checkpoint_on && (num_shards > 1 || is_async))
+    {
+        std::cout << "WARN: checkpoints hold the state of one hierarchy run in order, running unsharded and synchronously" << std::endl;
+        num_shards = 1;
+        is_async = false;
+    }
+
+    if (is_profile_on && (num_shards > 1 || is_async || is_sweep || !core_trace_paths.empty()))
+    {
+        std::cout << "WARN: profiling follows one hierarchy on one thread, running unsharded and synchronously" << std::endl;
+        num_shards = 1;
+        is_async = false;
+    }
+
+    if (!stats_out.sets.empty() && num_shards > 1)
+    {
+        std::cout << "WARN: per set counters are kept by one hierarchy, running unsharded" << std::endl;
+        num_shards = 1;
+    }
+
+    bool is_sampling_on = !interval_path.empty() || is_progress_on;
+    if (is_sampling_on && (is_sweep || !core_trace_paths.empty()))
+    {
+        std::cout << "WARN: interval stats follow a single core, ignoring --interval-stats and --progress" << std::endl;
+        is_sampling_on = false;
+    }
+    if (is_sampling_on && (num_shards > 1 || is_async))
+    {
+        std::cout << "WARN: interval stats sample one hierarchy run in order, running unsharded and synchronously" << std::endl;
+        num_shards = 1;
+        is_async = false;
+    }
+
+    if (is_classify_on && (is_sweep || !core_trace_paths.empty()))
+    {
+        std::cout << "WARN: misses are classified for a single core, ignoring --classify-misses" << std::endl;
+        is_classify_on = false;
+    }
+    if (is_classify_on && num_shards > 1)
+    {
+        std::cout << "WARN: the shadow of a classified cache spans all its sets, running unsharded" << std::endl;
+        num_shards = 1;
+    }
+
+    bool is_locality_on = !locality_path.empty();
+    if (is_locality_on && (is_sweep || !core_trace_paths.empty()))
+    {
+        std::cout << "WARN: locality is profiled for a single core, ignoring --locality" << std::endl;
+        is_locality_on = false;
+    }
+    if (is_locality_on && (num_shards > 1 || is_async))
+    {
+        std::cout << "WARN: locality is profiled on the request streams of one hierarchy in order, running unsharded and synchronously" << std::endl;
+        num_shards = 1;
+        is_async = false;
+    }
+
+    bool is_ffwd_on = ffwd_num > 0 || ffwd_to > 0;
+    if (is_ffwd_on && num_shards > 1)
+    {
+        std::cout << "WARN: fast-forwarding warms one hierarchy, running unsharded" << std::endl;
+        num_shards = 1;
+    }
 
     // inferred params
     unsigned l2_cache_block_size = 16;
     unsigned l2_cache_num_victim_blocks = 0;
     
     // construct a logger
-    logger log(verbose::INFO);
+    bool is_debug_events_on = !debug_events_path.empty();
+    logger log(is_debug_on || is_debug_events_on ? verbose::DEBUG : verbose::INFO);
+
+    if ((is_debug_on || is_debug_events_on) && log_max_level < verbose::DEBUG) {
+        std::cout << "WARN: DEBUG messages are compiled out of this build, see LOG_MAX_LEVEL" << std::endl;
+    }
+
+    // DEBUG messages recorded in binary for log_decode instead of printed
+    std::unique_ptr<bin_log_sink> debug_sink;
+    if (is_debug_events_on)
+    {
+        debug_sink.reset(new bin_log_sink(debug_events_path));
+        if (!debug_sink->is_open())
+        {
+            log.log(debug_sink.get(), verbose::FATAL, debug_events_path + ": Unable to create file");
+            return 1;
+        }
+        log.set_sink(debug_sink.get());
+    }
+
+    // the trace of core 0 and one more trace per core
+    if (!core_trace_paths.empty())
+    {
+        core_trace_paths.insert(core_trace_paths.begin(), trace_file_path);
+        if (core_trace_paths.size() > multicore_sim::MAX_CORES)
+        {
+            std::cout << "WARN: at most " << multicore_sim::MAX_CORES << " cores are simulated, ignoring the other traces" << std::endl;
+            core_trace_paths.resize(multicore_sim::MAX_CORES);
+        }
+        if (cfg.vc_num_blocks != 0)
+        {
+            std::cout << "WARN: private L1s have no victim cache, running without" << std::endl;
+            cfg.vc_num_blocks = 0;
+        }
+
+        std::cout << "===== Simulator configuration =====" << std::endl;
+        std::cout << " L1_SIZE:\t\t" << cfg.l1_size << std::endl;
+        std::cout << " L1_ASSOC:\t\t" << cfg.l1_assoc << std::endl;
+        std::cout << " L1_BLOCSIZE:\t\t" << cfg.l1_block_size << std::endl;
+        std::cout << " L2_SIZE:\t\t" << cfg.l2_size << std::endl;
+        std::cout << " L2_ASSOC:\t\t" << cfg.l2_assoc << std::endl;
+        std::cout << " cores:\t\t" << core_trace_paths.size() << std::endl;
+        std::cout << " quantum:\t\t" << quantum << std::endl << std::endl;
+
+        if (stats_out.is_any()) {
+            std::cout << "WARN: stats are only exported for a single core, ignoring --stats-json, --stats-csv and --set-stats" << std::endl;
+        }
+
+        multicore_sim multicore(cfg, core_trace_paths, quantum, log);
+        if (!multicore.run()) {
+            return 1;
+        }
+        multicore.print_results();
+
+        return 0;
+    }
 
     // initialize performance counters
     perf_counters::cache_counters hpm_counters_l1;
@@ -49,6 +416,8 @@ int main(int argc, char* argv[])
         trace_file_path,
         log
     );
+    CPU.set_batch_size(batch_size);
+    CPU.set_pipelined(is_pipelined);
      
     // l1
     cache l1_cache(
@@ -58,9 +427,18 @@ int main(int argc, char* argv[])
         l1_cache_block_size,
         l1_cache_num_victim_blocks,
         log,
-        &hpm_counters_l1);
+        &hpm_counters_l1,
+        repl_policy,
+        repl_seed);
     // attach performance counter
     hpm_counters_l1.attach_cache(&l1_cache);
+    if (!stats_out.sets.empty()) {
+        l1_cache.enable_set_counters();
+    }
+    if (is_classify_on) {
+        l1_cache.enable_miss_classes();
+    }
+    l1_cache.reserve_batch(batch_size);
 
     // performance counter for L2
     perf_counters::cache_counters hpm_counters_l2;
@@ -68,44 +446,25 @@ int main(int argc, char* argv[])
     // memory test
     main_memory main_mem(log);
 
-    // make connections
-    CPU.mk_next_connection(&l1_cache);
-
-    // CACTI results for l1
-    float l1_avg_access_time;
-    float l1_energy;
-    float l1_area;
-
-    int l1_cacti_res = get_cacti_results(l1_cache_size,
-                        l1_cache_block_size,
-                        l1_cache_assoc,
-                        &l1_avg_access_time,
-                        &l1_energy,
-                        &l1_area);
-    assert(l1_cacti_res == 0);
-
-    float l1_vc_avg_access_time = 0.0f;
-    float l1_vc_energy = 0.0f;
-    float l1_vc_area = 0.0f;
-    int l1_vc_cacti_res = 3;
-
-    // if victim cache enabled
-    if (l1_cache_num_victim_blocks != 0)
-    {
-        l1_vc_cacti_res = get_cacti_results(
-            l1_cache_num_victim_blocks * l1_cache_block_size,
-            l1_cache_num_victim_blocks,
-            l1_cache_num_victim_blocks,
-            &l1_vc_avg_access_time,
-            &l1_vc_energy,
-            &l1_vc_area
-        );
-
-        // if cacti throws an error
-        if (l1_vc_cacti_res != 0)
-        {
-            l1_vc_avg_access_time = 0.2f;
+    // whatever the store is missing runs in parallel
+    cacti.prefetch(cacti_keys(cfg), num_threads);
+
+    // CACTI results for every level
+    sim_figures figs;
+    std::string cacti_failed_level;
+    if (!get_sim_figures(cacti, cfg, figs, cacti_failed_level))
+    {
+        cacti_key failed_key = cacti_failed_level == "L1" ?
+            cacti_key(l1_cache_size, l1_cache_block_size, l1_cache_assoc) : cacti_key(l2_cache_size, 16, l2_cache_assoc);
+
+        // the table only helps a run that did not already rely on it
+        if (cacti_mode != CACTI_MODE::TABLE && cacti_model.interpolate(failed_key).error == 0) {
+            log.log(&cacti, verbose::FATAL, "CACTI failed on " + cacti_failed_level + ", --cacti=table estimates it from its neighbours");
+        }
+        else {
+            log.log(&cacti, verbose::FATAL, "CACTI failed on " + cacti_failed_level + ", the organisation is outside what the table and CACTI can model");
         }
+        return 1;
     }
 
     std::cout << "===== Simulator configuration =====" << std::endl;
@@ -117,24 +476,206 @@ int main(int argc, char* argv[])
     std::cout << " L2_ASSOC:\t\t" << l2_cache_assoc << std::endl;
     std::cout << " trace_file:\t\t" << trace_file_path << std::endl << std::endl;
 
-    // for l2
-    float l2_avg_access_time = 0.0f;
-    float l2_energy = 0.0f;
-    float l2_area = 0.0f;
+    // heap allocations while the trace is simulated
+    uint64_t sim_allocs = 0;
+    if (is_alloc_count_on) {
+        CPU.set_alloc_warmup(alloc_count::WARMUP_RECORDS);
+    }
+
+    // requests sent one at a time run through a static hierarchy for common shapes, unless every
+    // module step is logged or profiled. Batches already run a compiled kernel per level through the modules
+    bool is_static_allowed = batch_size == 0 && !is_dynamic && !is_debug_on && !is_debug_events_on && !is_profile_on && !is_locality_on;
+    std::unique_ptr<module> static_hier;
+
+    // counters sampled every interval on the simulating thread and written out on a background one
+    std::unique_ptr<interval_sampler> sampler;
+    if (is_sampling_on)
+    {
+        sampler.reset(new interval_sampler(interval_path, interval, is_progress_on));
+        if (!sampler->is_open())
+        {
+            log.log(sampler.get(), verbose::FATAL, interval_path + ": Unable to create file");
+            return 1;
+        }
+
+        sampler->add_level("l1", &hpm_counters_l1);
+        if (l2_cache_size != 0) {
+            sampler->add_level("l2", &hpm_counters_l2);
+        }
+        sampler->set_mem_traffic(&main_mem.mem_access);
+        CPU.set_sampler(sampler.get());
+    }
 
-    if (l2_cache_size != 0)
+    // stages of the run, charged by a probe in front of every level
+    std::unique_ptr<profiler> prof;
+    std::vector<std::unique_ptr<prof_probe>> probes;
+    if (is_profile_on)
     {
-        // CACTI results for l2
+        prof.reset(new profiler());
+        CPU.set_profiler(prof.get());
+    }
 
+    // locality of the request stream into every level, in blocks of the level or of the one before memory
+    std::vector<std::unique_ptr<locality_profile>> localities;
+    std::vector<std::unique_ptr<locality_probe>> locality_probes;
 
-        int l2_cacti_res = get_cacti_results(l2_cache_size,
-                            l2_cache_block_size,
-                            l2_cache_assoc,
-                            &l2_avg_access_time,
-                            &l2_energy,
-                            &l2_area);
-        assert(l2_cacti_res == 0);
-        
+    // connect the core through levels, closest first, with a probe in front of each when profiling
+    // and when profiling locality
+    auto connect_levels = [&](const std::vector<module*>& levels, const std::vector<unsigned>& block_sizes)
+    {
+        module* last = &CPU;
+        unsigned prev_stage = CPU.get_prof_stage();
+        for (size_t i = 0; i < levels.size(); i++)
+        {
+            module* level = levels[i];
+            if (prof != nullptr)
+            {
+                probes.emplace_back(new prof_probe(*prof, prev_stage, level->get_name(), log));
+                last->mk_next_connection(probes.back().get());
+                last = probes.back().get();
+                prev_stage = probes.back()->get_stage();
+            }
+            if (is_locality_on)
+            {
+                localities.emplace_back(new locality_profile(level->get_name(), __builtin_ctz(block_sizes[i])));
+                locality_probes.emplace_back(new locality_probe(*localities.back(), level->get_name(), log));
+                last->mk_next_connection(locality_probes.back().get());
+                last = locality_probes.back().get();
+            }
+            last->mk_next_connection(level);
+            last = level;
+        }
+    };
+
+    // runs the trace from the record the restored checkpoint was taken after, taking a checkpoint at
+    // checkpoint_at records on the way
+    auto run_trace = [&](cache* l2_cache) -> bool
+    {
+        uint64_t first_record = 0;
+
+        // checkpoints name the trace they were taken on
+        std::unique_ptr<trace_reader> ckpt_trace;
+        if (is_checkpoint_on)
+        {
+            ckpt_trace.reset(new trace_reader(trace_file_path));
+            if (!ckpt_trace->is_open())
+            {
+                log.log(&CPU, verbose::FATAL, trace_file_path + ": Unable to find file");
+                return false;
+            }
+        }
+
+        if (!restore_path.empty())
+        {
+            std::string err;
+            if (!restore_checkpoint(restore_path, cfg, *ckpt_trace, first_record, l1_cache, l2_cache, main_mem, err))
+            {
+                log.log(&CPU, verbose::FATAL, restore_path + ": " + err);
+                return false;
+            }
+            log.log(&CPU, verbose::INFO, "Restored " + restore_path + " taken after " + std::to_string(first_record) + " records");
+        }
+
+        if (is_ffwd_on)
+        {
+            // --ffwd-to counts from the start of the trace, --ffwd from where the run starts
+            uint64_t ffwd_end = ffwd_to > 0 ? ffwd_to : first_record + ffwd_num;
+            if (ffwd_end < first_record) {
+                std::cout << "WARN: fast-forward to " << ffwd_end << " is before the restored checkpoint, not fast-forwarding" << std::endl;
+            }
+            else
+            {
+                trace_reader trace(trace_file_path);
+                TRACE_STATUS status = TRACE_STATUS::VALID;
+                uint64_t num_ffwd = 0;
+
+                auto start = std::chrono::steady_clock::now();
+                if (trace.is_open() && (status = trace.skip(first_record)) == TRACE_STATUS::VALID) {
+                    num_ffwd = fast_forward(trace, ffwd_end - first_record, l1_cache, l2_cache, status);
+                }
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+                if (status != TRACE_STATUS::VALID && status != TRACE_STATUS::END_OF_TRACE)
+                {
+                    log.log(&CPU, verbose::FATAL, trace_file_path + ": Invalid record at line " + std::to_string(trace.get_line()));
+                    return false;
+                }
+
+                // a detailed phase without records has no rates to report
+                mem_req next_req;
+                if (num_ffwd < ffwd_end - first_record || status != TRACE_STATUS::VALID || trace.next(next_req) != TRACE_STATUS::VALID)
+                {
+                    log.log(&CPU, verbose::FATAL, trace_file_path + ": Trace ends after " + std::to_string(first_record + num_ffwd) +
+                            " records, nothing is left to simulate after fast-forwarding to record " + std::to_string(ffwd_end));
+                    return false;
+                }
+
+                std::ostringstream rate;
+                rate << std::setprecision(4) << (elapsed.count() > 0.0 ? num_ffwd / elapsed.count() / 1e6 : 0.0);
+                log.log(&CPU, verbose::INFO, "Fast-forwarded " + std::to_string(num_ffwd) + " records, " + rate.str() + " M records/s");
+
+                // detailed simulation starts from zero
+                first_record += num_ffwd;
+                hpm_counters_l1.reset();
+                hpm_counters_l2.reset();
+                main_mem.mem_access = 0;
+            }
+        }
+
+        if (!checkpoint_path.empty())
+        {
+            if (checkpoint_at < first_record) {
+                std::cout << "WARN: checkpoint at " << checkpoint_at << " is before the restored one, taking it right away" << std::endl;
+            }
+
+            CPU.set_range(first_record, checkpoint_at > first_record ? checkpoint_at - first_record : 0);
+            CPU.sequencer();
+            first_record += CPU.get_num_issued();
+
+            if (!save_checkpoint(checkpoint_path, cfg, *ckpt_trace, first_record, l1_cache, l2_cache, main_mem))
+            {
+                log.log(&CPU, verbose::FATAL, checkpoint_path + ": Unable to write checkpoint");
+                return false;
+            }
+            log.log(&CPU, verbose::INFO, "Checkpoint after " + std::to_string(first_record) + " records written to " + checkpoint_path);
+        }
+
+        CPU.set_range(first_record);
+        CPU.sequencer();
+
+        return true;
+    };
+
+    if (num_shards > 1)
+    {
+        // every shard picks its sets out of the trace, decoded a chunk at a time
+        trace_reader trace(trace_file_path);
+        if (!trace.is_open())
+        {
+            log.log(&trace, verbose::FATAL, trace_file_path + ": Unable to find file");
+            return 1;
+        }
+
+        sharded_sim sharded(cfg, num_shards, batch_size, log);
+        sim_allocs = alloc_count::get();
+        TRACE_STATUS status = sharded.run(trace);
+        sim_allocs = alloc_count::get() - sim_allocs;
+
+        if (status != TRACE_STATUS::END_OF_TRACE)
+        {
+            log.log(&trace, verbose::FATAL, trace_file_path + ": Invalid record at line " + std::to_string(trace.get_line()));
+            return 1;
+        }
+
+        // print contents
+        sharded.print();
+
+        hpm_counters_l1 = sharded.get_counters(0);
+        hpm_counters_l2 = sharded.get_counters(1);
+        main_mem.mem_access = sharded.get_mem_traffic();
+    }
+    else if (l2_cache_size != 0)
+    {
         //l2
         cache l2_cache(
             "L2",
@@ -143,16 +684,62 @@ int main(int argc, char* argv[])
             l2_cache_block_size,
             l2_cache_num_victim_blocks,
             log,
-            &hpm_counters_l2);
+            &hpm_counters_l2,
+            repl_policy,
+            repl_seed);
         // attach performance counter
         hpm_counters_l2.attach_cache(&l2_cache);
+        if (!stats_out.sets.empty()) {
+            l2_cache.enable_set_counters();
+        }
+        if (is_classify_on) {
+            l2_cache.enable_miss_classes();
+        }
+        l2_cache.reserve_batch(2 * batch_size);
+
+        // links running L2 and memory on their own threads
+        async_link l1_l2_link("L1-L2 link", log);
+        async_link l2_mem_link("L2-Memory link", log);
+
+        if (is_static_allowed) {
+            static_hier = make_static_hierarchy(cfg, l1_cache, &l2_cache, main_mem, log);
+        }
 
         // make rest of the connections
-        l1_cache.mk_next_connection(&l2_cache);
-        l2_cache.mk_next_connection(&main_mem);
+        if (static_hier != nullptr) {
+            CPU.mk_next_connection(static_hier.get());
+        }
+        else if (is_async)
+        {
+            CPU.mk_next_connection(&l1_cache);
+            l1_cache.mk_next_connection(&l1_l2_link);
+            l1_l2_link.mk_next_connection(&l2_cache);
+            l2_cache.mk_next_connection(&l2_mem_link);
+            l2_mem_link.mk_next_connection(&main_mem);
+
+            // a level sends at most a writeback and a fetch per request it receives
+            l1_l2_link.reserve(2 * batch_size);
+            l2_mem_link.reserve(4 * batch_size);
+
+            l1_l2_link.start();
+            l2_mem_link.start();
+        }
+        else {
+            connect_levels({&l1_cache, &l2_cache, &main_mem}, {l1_cache_block_size, l2_cache_block_size, l2_cache_block_size});
+        }
 
         // start CPU sequencer
-        CPU.sequencer();
+        sim_allocs = alloc_count::get();
+        bool is_run = run_trace(&l2_cache);
+        sim_allocs = alloc_count::get() - sim_allocs;
+
+        // drain the links in hierarchy order
+        l1_l2_link.stop();
+        l2_mem_link.stop();
+
+        if (!is_run) {
+            return 1;
+        }
 
         // print contents
         l1_cache.print();
@@ -160,31 +747,84 @@ int main(int argc, char* argv[])
     }
     else
     {
+        // link running memory on its own thread
+        async_link l1_mem_link("L1-Memory link", log);
+
+        if (is_static_allowed) {
+            static_hier = make_static_hierarchy(cfg, l1_cache, nullptr, main_mem, log);
+        }
+
         // no L2, so connect to main memory
-        l1_cache.mk_next_connection(&main_mem);
+        if (static_hier != nullptr) {
+            CPU.mk_next_connection(static_hier.get());
+        }
+        else if (is_async)
+        {
+            CPU.mk_next_connection(&l1_cache);
+            l1_cache.mk_next_connection(&l1_mem_link);
+            l1_mem_link.mk_next_connection(&main_mem);
+            l1_mem_link.reserve(2 * batch_size);
+            l1_mem_link.start();
+        }
+        else {
+            connect_levels({&l1_cache, &main_mem}, {l1_cache_block_size, l1_cache_block_size});
+        }
 
         // start CPU sequencer
-        CPU.sequencer();
+        sim_allocs = alloc_count::get();
+        bool is_run = run_trace(nullptr);
+        sim_allocs = alloc_count::get() - sim_allocs;
+
+        l1_mem_link.stop();
+
+        if (!is_run) {
+            return 1;
+        }
 
         // print contents
         l1_cache.print();
     }
 
-    float l1_swap_request_rate = 0.0f;
-    float l1_vc_miss_rate = 0.0f;
-    float l2_miss_rate = 0.0f;
+    if (sampler != nullptr) {
+        sampler->finish(CPU.get_num_issued());
+    }
 
-    l1_vc_miss_rate = (hpm_counters_l1.read_misses + hpm_counters_l1.write_misses - hpm_counters_l1.num_swaps) / (float)(hpm_counters_l1.num_reads + hpm_counters_l1.num_writes);
- 
-    if (l2_cache_size != 0) {
-        l2_miss_rate = hpm_counters_l2.read_misses / (float) hpm_counters_l2.num_reads;
+    if (is_debug_events_on)
+    {
+        debug_sink->close();
+        log.log<verbose::INFO>(debug_sink.get(), "Recorded %lu DEBUG events, %lu bytes to %s",
+            debug_sink->get_num_events(), debug_sink->get_num_bytes(), debug_events_path);
     }
 
-    // compute swap rate 
-    if (l1_cache_num_victim_blocks != 0) {
-        l1_swap_request_rate = hpm_counters_l1.num_swap_req / (float) (hpm_counters_l1.num_reads + hpm_counters_l1.num_writes);
+    if (is_alloc_count_on)
+    {
+        uint64_t num_accesses = hpm_counters_l1.num_reads + hpm_counters_l1.num_writes;
+        std::ostringstream per_access;
+        per_access << std::setprecision(4) << (num_accesses > 0 ? sim_allocs / (double) num_accesses : 0.0);
+        log.log(&CPU, verbose::INFO, "Heap allocations during simulation: " + std::to_string(sim_allocs) + ", " + per_access.str() + " per access");
+
+        // the request path should not allocate once its buffers have their size
+        if (CPU.get_steady_allocs() != UINT64_MAX)
+        {
+            log.log(&CPU, verbose::INFO, "Heap allocations after the first " + std::to_string(alloc_count::WARMUP_RECORDS) +
+                " records: " + std::to_string(CPU.get_steady_allocs()));
+        }
+        else {
+            log.log(&CPU, verbose::INFO, "Heap allocations after warm-up not counted, the core issued fewer than " +
+                std::to_string(alloc_count::WARMUP_RECORDS) + " records");
+        }
     }
 
+    stats_run run;
+    run.cfg = cfg;
+    run.res.l1 = hpm_counters_l1;
+    run.res.l2 = hpm_counters_l2;
+    run.res.mem_traffic = main_mem.mem_access;
+    run.metrics = compute_metrics(cfg, run.res, figs);
+    run.has_metrics = true;
+
+    const sim_metrics& metrics = run.metrics;
+
     // print simulation results
     std::cout << "===== Simulation results (raw) =====" << std::endl;
     std::cout << " a. number of L1 reads:\t" << hpm_counters_l1.num_reads << std::endl;
@@ -192,70 +832,69 @@ int main(int argc, char* argv[])
     std::cout << " c. number of L1 writes:\t" << hpm_counters_l1.num_writes << std::endl;
     std::cout << " d. number of L1 write misses:\t" << hpm_counters_l1.write_misses << std::endl;
     std::cout << " e. number of swap requests:\t" << hpm_counters_l1.num_swap_req << std::endl;
-    std::cout << " f. swap request rate:\t" << std::setprecision(4) <<  l1_swap_request_rate << std::endl;
+    std::cout << " f. swap request rate:\t" << std::setprecision(4) <<  metrics.swap_request_rate << std::endl;
     std::cout << " g. number of swaps:\t" << hpm_counters_l1.num_swaps << std::endl;
-    std::cout << " h. combined L1+VC miss rate:\t" << std::setprecision(4) << l1_vc_miss_rate << std::endl;
+    std::cout << " h. combined L1+VC miss rate:\t" << std::setprecision(4) << metrics.l1_vc_miss_rate << std::endl;
     std::cout << " i. number of writebacks from L1/VC:\t" << hpm_counters_l1.num_writebacks << std::endl;
     std::cout << " j. number of L2 reads:\t" << hpm_counters_l2.num_reads << std::endl;
     std::cout << " k. number of L2 read misses:\t" << hpm_counters_l2.read_misses << std::endl;
     std::cout << " l. number of L2 writes:\t" << hpm_counters_l2.num_writes << std::endl;
     std::cout << " m. number of L2 write misses:\t" << hpm_counters_l2.write_misses << std::endl;
-    std::cout << " n. L2 miss rate:\t" << std::setprecision(4) << l2_miss_rate << std::endl;
+    std::cout << " n. L2 miss rate:\t" << std::setprecision(4) << metrics.l2_miss_rate << std::endl;
     std::cout << " o. number of writebacks from L2:\t" << hpm_counters_l2.num_writebacks << std::endl;
     std::cout << " p. total memory traffic:\t" << main_mem.mem_access << std::endl;
 
-    // performance analysis
-    double average_acc_time = 0.0f;
-    double e_delay_prod = 0.0f;
-    double total_area = 0.0f;
-    double total_acc_time = 0.0f;
-    double mem_energy = 0.05f;
-    double mem_miss_penalty = 20.0f + l1_cache_block_size / 16.0f;
-    double l1_miss_penalty = 0.0f;
+    if (is_classify_on)
+    {
+        std::cout << std::endl << "===== Miss classification (3C) =====" << std::endl;
+        const char* names[] = {"L1", "L2"};
+        const perf_counters::cache_counters* levels[] = {&hpm_counters_l1, &hpm_counters_l2};
+        for (unsigned lvl = 0; lvl < (l2_cache_size != 0 ? 2u : 1u); lvl++)
+        {
+            const perf_counters::cache_counters& c = *levels[lvl];
+            uint64_t misses = c.compulsory_misses + c.capacity_misses + c.conflict_misses;
+            std::pair<const char*, uint64_t> classes[] = {
+                {"compulsory", c.compulsory_misses}, {"capacity", c.capacity_misses}, {"conflict", c.conflict_misses}
+            };
+            for (const auto& cls : classes)
+            {
+                std::cout << " " << names[lvl] << " " << cls.first << " misses:\t" << cls.second << " (" << std::fixed << std::setprecision(2)
+                          << (misses > 0 ? 100.0 * cls.second / misses : 0.0) << "%)" << std::defaultfloat << std::endl;
+            }
+        }
+    }
 
-    double l1_miss_penalty_num = 0.0f;
+    // print
+    std::cout << std::endl << "===== Simulation results (performance) =====" << std::endl;
+    std::cout << " 1. average access time:\t" << std::setprecision(5) << metrics.average_access_time << std::endl;
+    std::cout << " 2. energy-delay product:\t" << std::setprecision(14) <<  metrics.energy_delay_product << std::endl;
+    std::cout << " 3. total area:\t" << std::setprecision(3) << metrics.total_area << std::endl;
 
+    if (is_locality_on)
+    {
+        std::cout << std::endl << "===== Locality =====" << std::endl;
+        std::vector<locality_profile*> profiles;
+        for (const std::unique_ptr<locality_profile>& profile : localities)
+        {
+            std::cout << " " << profile->get_name() << " stream:\t" << profile->get_accesses() << " accesses, "
+                      << profile->get_blocks() << " blocks" << std::endl;
+            profiles.push_back(profile.get());
+        }
 
-    // get l1 mis penalty
-    if (l2_cache_size == 0) {
-        l1_miss_penalty = mem_miss_penalty;
-    } else {
-        l1_miss_penalty = l2_avg_access_time + l2_miss_rate * static_cast<double>(mem_miss_penalty);
+        if (!write_locality_csv(locality_path, profiles))
+        {
+            log.log(&CPU, verbose::FATAL, locality_path + ": Unable to write locality profile");
+            return 1;
+        }
     }
 
-    // get total area
-    total_area = l1_area + l2_area + l1_vc_area;
-
-    // average acceess time
-    average_acc_time = l1_avg_access_time + l1_vc_miss_rate * l1_miss_penalty + l1_swap_request_rate * l1_vc_avg_access_time;
-    
-    // total access time
-    if (l2_cache_size == 0) {
-        l1_miss_penalty_num = (hpm_counters_l1.read_misses + hpm_counters_l1.write_misses) * mem_miss_penalty;
-    } else {
-        l1_miss_penalty_num = static_cast<double>(l2_avg_access_time) * (hpm_counters_l2.num_reads + hpm_counters_l2.num_writes) + (hpm_counters_l2.read_misses + hpm_counters_l2.write_misses) * mem_miss_penalty;
-    }
-    total_acc_time = static_cast<double>(l1_avg_access_time) * (hpm_counters_l1.num_reads + hpm_counters_l1.num_writes) + \
-                     static_cast<double>(l1_miss_penalty_num) + \
-                    (hpm_counters_l1.num_swaps) * static_cast<double>(l1_vc_avg_access_time);
-
-    // energy delay product
-    e_delay_prod = (hpm_counters_l1.num_reads + hpm_counters_l1.num_writes + hpm_counters_l1.read_misses + hpm_counters_l1.write_misses) * static_cast<double>(l1_energy);
-    if (l1_cache_num_victim_blocks != 0)
-        e_delay_prod += (2*hpm_counters_l1.num_swaps) * static_cast<double>(l1_vc_energy);
-    if (l2_cache_size != 0) {
-        e_delay_prod += (hpm_counters_l2.read_misses + hpm_counters_l2.write_misses + hpm_counters_l2.num_reads + hpm_counters_l2.num_writes) * static_cast<double>(l2_energy);
-        e_delay_prod += (hpm_counters_l2.read_misses + hpm_counters_l2.write_misses + hpm_counters_l2.num_writebacks) * static_cast<double>(mem_energy);
-    } else {
-        e_delay_prod += (hpm_counters_l1.read_misses + hpm_counters_l1.write_misses - hpm_counters_l1.num_swaps + hpm_counters_l1.num_writebacks) * static_cast<double>(mem_energy);
-    }
-    e_delay_prod = e_delay_prod * total_acc_time;
+    if (prof != nullptr) {
+        prof->print(CPU.get_num_issued());
+    }
 
-    // print
-    std::cout << std::endl << "===== Simulation results (performance) =====" << std::endl;
-    std::cout << " 1. average access time:\t" << std::setprecision(5) << average_acc_time << std::endl;
-    std::cout << " 2. energy-delay product:\t" << std::setprecision(14) <<  e_delay_prod << std::endl;
-    std::cout << " 3. total area:\t" << std::setprecision(3) << total_area << std::endl;
+    if (stats_out.is_any() && !export_stats(stats_out, {run}, log)) {
+        return 1;
+    }
         
     return 0;
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
  */
 
 #include <module.h>
+#include <checkpoint.h>
 
 #ifndef MAIN_MEM_H
 #define MAIN_MEM_H
@@ -16,14 +17,14 @@ class main_memory : public module
         unsigned _mem_acc_addr;
     public:
 
-        unsigned mem_access;
+        uint64_t mem_access;
 
         /**
          * @details constructor that 
          */
         main_memory(logger log_obj) : module("Memory", log_obj)
         {
-            log.log(this, verbose::DEBUG, "Constructing Main Memory");
+            log.log<verbose::DEBUG>(this, "Constructing Main Memory");
             mk_next_connection(nullptr);
             mem_access = 0;
         }
@@ -38,21 +39,49 @@ class main_memory : public module
                 // increment counter for memory accessses
                 mem_access = mem_access + 1;
                 
-                log.log(this, verbose::DEBUG, "Received request packet " +  req_ptr_prev -> get_msg_str());
+                log.log<verbose::DEBUG>(this, "Received request packet " MEM_REQ_FMT, req_ptr_prev -> req_op_type, req_ptr_prev -> addr);
 
                 _mem_acc_addr = req_ptr_prev -> addr;
                 
-                auto resp = new resp_msg(true, _mem_acc_addr);
+                resp_msg resp(true, _mem_acc_addr);
 
                 // register this reponse
-                resp_ptr_prev = resp;
+                resp_ptr_prev = &resp;
 
-                put_to_prev(resp);
+                put_to_prev(resp_ptr_prev);
                 
-                delete resp;
+                // the response only lives for this call
+                resp_ptr_prev = nullptr;
             }
         }
 
+        /**
+         * @details Override get_batch_frm_prev, every request of a batch is a memory access
+         */
+        void get_batch_frm_prev(mem_req* reqs, size_t num)
+        {
+            if (ifc_prev != nullptr)
+            {
+                log.log<verbose::DEBUG>(this, "Received batch of %lu requests", num);
+
+                mem_access = mem_access + num;
+            }
+        }
+
+        void save(ckpt_writer& out) const {
+            out.put<uint64_t>(mem_access);
+        }
+
+        bool restore(ckpt_reader& in)
+        {
+            uint64_t num = 0;
+            if (!in.get(num)) {
+                return false;
+            }
+            mem_access = num;
+            return true;
+        }
+
 };
 
 #endif // MAIN_MEM_H
\ No newline at end of file
@@ -4,12 +4,19 @@
  * @author Edwin Joy <edwin7026@gmail.com>
  */
 
+#ifndef MESSAGE_H
+#define MESSAGE_H
+
 // standard include
 #include <string>
 
 // local include
 #include <common.h>
 
+// formats of messages inside a log message, followed by their two fields as arguments
+#define MEM_REQ_FMT "{OP: %u, ADDR: 0x%x}"
+#define RESP_MSG_FMT "{RDY: %u, ADDR: 0x%x}"
+
 /**
  * @details Enumerates different memory operations
  */
@@ -60,4 +67,6 @@ struct resp_msg
     {
         return "{RDY: " + std::to_string(ready) + ", ADDR: 0x" + to_hex_str(addr) + "}";
     }
-};
\ No newline at end of file
+};
+
+#endif // MESSAGE_H
\ No newline at end of file
@@ -0,0 +1,159 @@
+/**
+ * @file miss_class.cpp
+ * @details This file contains definitions of the 3C miss classifier
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "miss_class.h"
+
+miss_classifier::miss_classifier(uint32_t capacity) :
+    _capacity(capacity > 0 ? capacity : 1),
+    _ids(2 * (size_t) _capacity),
+    _head(NONE),
+    _tail(NONE),
+    _num_held(0)
+{
+}
+
+void miss_classifier::unlink(uint32_t id)
+{
+    if (_prev[id] != NONE) {
+        _next[_prev[id]] = _next[id];
+    }
+    else {
+        _head = _next[id];
+    }
+
+    if (_next[id] != NONE) {
+        _prev[_next[id]] = _prev[id];
+    }
+    else {
+        _tail = _prev[id];
+    }
+}
+
+void miss_classifier::push_front(uint32_t id)
+{
+    _prev[id] = NONE;
+    _next[id] = _head;
+    if (_head != NONE) {
+        _prev[_head] = id;
+    }
+    else {
+        _tail = id;
+    }
+    _head = id;
+}
+
+MISS_CLASS miss_classifier::access(unsigned block)
+{
+    bool is_new;
+    uint32_t id = _ids.find_or_add(block, is_new);
+
+    MISS_CLASS miss_class = CONFLICT;
+    if (is_new)
+    {
+        _prev.push_back(NONE);
+        _next.push_back(NONE);
+        _is_held.push_back(0);
+        miss_class = COMPULSORY;
+    }
+    else if (!_is_held[id]) {
+        miss_class = CAPACITY;
+    }
+
+    // the shadow hits by moving the block to the front, misses by filling it there
+    if (_is_held[id])
+    {
+        if (_head != id)
+        {
+            unlink(id);
+            push_front(id);
+        }
+        return miss_class;
+    }
+
+    if (_num_held == _capacity)
+    {
+        uint32_t lru = _tail;
+        unlink(lru);
+        _is_held[lru] = 0;
+        _num_held--;
+    }
+
+    push_front(id);
+    _is_held[id] = 1;
+    _num_held++;
+
+    return miss_class;
+}
+
+void miss_classifier::save(ckpt_writer& out) const
+{
+    out.put<uint32_t>(_capacity);
+    out.put_vec(_ids.get_blocks());
+
+    // shadow from the most recent block on
+    std::vector<uint32_t> held;
+    held.reserve(_num_held);
+    for (uint32_t id = _head; id != NONE; id = _next[id]) {
+        held.push_back(id);
+    }
+    out.put_vec(held);
+}
+
+bool miss_classifier::restore(ckpt_reader& in)
+{
+    uint64_t num_blocks = 0;
+    if (!in.expect<uint32_t>(_capacity) || !in.get(num_blocks)) {
+        return false;
+    }
+
+    if (num_blocks > in.get_left() / sizeof(unsigned)) {
+        return in.fail();
+    }
+    std::vector<unsigned> blocks(num_blocks);
+    if (!in.get_array(blocks.data(), blocks.size())) {
+        return false;
+    }
+
+    uint64_t num_held = 0;
+    if (!in.get(num_held) || num_held > _capacity || num_held > num_blocks) {
+        return in.fail();
+    }
+    std::vector<uint32_t> held(num_held);
+    if (!in.get_array(held.data(), held.size())) {
+        return false;
+    }
+
+    _ids.clear();
+    for (unsigned block : blocks)
+    {
+        // ids are handed out in the order they were written
+        bool is_new;
+        _ids.find_or_add(block, is_new);
+        if (!is_new) {
+            return in.fail();
+        }
+    }
+
+    _prev.assign(_ids.size(), NONE);
+    _next.assign(_ids.size(), NONE);
+    _is_held.assign(_ids.size(), 0);
+    _head = NONE;
+    _tail = NONE;
+    _num_held = 0;
+
+    // refill from the least recent block so the most recent ends at the front
+    for (auto it = held.rbegin(); it != held.rend(); ++it)
+    {
+        if (*it >= _ids.size() || _is_held[*it]) {
+            return in.fail();
+        }
+        push_front(*it);
+        _is_held[*it] = 1;
+        _num_held++;
+    }
+
+    return true;
+}
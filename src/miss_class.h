@@ -0,0 +1,81 @@
+/**
+ * @file miss_class.h
+ * @details This file contains the 3C classifier of cache misses
+ *
+ * A miss is compulsory on the first access to its block, a capacity miss if a fully associative LRU
+ * cache of the same number of blocks misses too, and a conflict miss otherwise.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef MISS_CLASS_H
+#define MISS_CLASS_H
+
+// standard includes
+#include <vector>
+#include <cstdint>
+
+// local includes
+#include <checkpoint.h>
+#include <block_ids.h>
+
+/**
+ * @details Class of a miss
+ */
+enum MISS_CLASS
+{
+    COMPULSORY,
+    CAPACITY,
+    CONFLICT
+};
+
+/**
+ * @details Shadow of a cache classifying its misses. Blocks get dense ids on their first access, which
+ * makes the first-touch set, and a fully associative LRU shadow of the cache's capacity is kept as an
+ * intrusive list over the ids, so an access costs one hash lookup and a few list updates
+ */
+class miss_classifier
+{
+    private:
+        // end of the list
+        static constexpr uint32_t NONE = ~0u;
+
+        uint32_t _capacity;
+
+        // dense ids of the blocks seen so far
+        block_id_table _ids;
+
+        // shadow LRU list over ids, most recent at the head
+        std::vector<uint32_t> _prev;
+        std::vector<uint32_t> _next;
+        std::vector<uint8_t> _is_held;
+        uint32_t _head;
+        uint32_t _tail;
+        uint32_t _num_held;
+
+        void unlink(uint32_t id);
+        void push_front(uint32_t id);
+
+    public:
+
+        /**
+         * @details Classifier of a cache of capacity blocks
+         */
+        miss_classifier(uint32_t capacity);
+
+        /**
+         * @details Account an access to block, hit or miss, and get the class a miss of it falls in
+         */
+        MISS_CLASS access(unsigned block);
+
+        /**
+         * @details Write the seen blocks and the shadow
+         */
+        void save(ckpt_writer& out) const;
+
+        /**
+         * @details Read back what save wrote for a classifier of the same capacity, false if it does not match
+         */
+        bool restore(ckpt_reader& in);
+};
+
+#endif // MISS_CLASS_H
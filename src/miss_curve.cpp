@@ -0,0 +1,110 @@
+/**
+ * @file miss_curve.cpp
+ * @details Single pass LRU miss counts of every power of two cache size and associativity for a trace
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+#include <common.h>
+#include <trace_reader.h>
+#include <stack_distance.h>
+
+/**
+ * @details Print how the miss curve is run
+ */
+static void print_usage(const char* prog)
+{
+    std::cout << "usage: " << prog << " <trace> <block size> [max cache size]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 4)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string trace_path = argv[1];
+
+    unsigned block_size = 0;
+    uint64_t max_size = 1 << 20;
+    const char* arg = argv[2];
+    try
+    {
+        block_size = parse_number<unsigned>(arg);
+        if (argc > 3)
+        {
+            // addresses are 32 bits, no larger cache tells anything apart
+            arg = argv[3];
+            max_size = parse_number<uint32_t>(arg);
+        }
+    }
+    catch (const std::logic_error&)
+    {
+        std::cout << "FATAL: " << arg << ": not a whole number in range" << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (block_size == 0 || (block_size & (block_size - 1)) != 0 || block_size > max_size)
+    {
+        std::cout << "FATAL: Block size must be a power of two no larger than the cache" << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    unsigned block_bits = 0;
+    while ((1u << block_bits) < block_size) {
+        block_bits++;
+    }
+
+    logger log(verbose::INFO);
+
+    trace_reader trace(trace_path);
+    if (!trace.is_open())
+    {
+        log.log(&trace, verbose::FATAL, trace_path + ": Unable to find file");
+        return 1;
+    }
+
+    stack_distance engine(block_bits, max_size);
+
+    mem_req req;
+    TRACE_STATUS status;
+    while ((status = trace.next(req)) == TRACE_STATUS::VALID) {
+        engine.access(req);
+    }
+
+    if (status != TRACE_STATUS::END_OF_TRACE)
+    {
+        log.log(&trace, verbose::FATAL, trace_path + ": Invalid record at line " + std::to_string(trace.get_line()));
+        return 1;
+    }
+
+    uint64_t reads = engine.get_accesses(OP_TYPE::LOAD);
+    uint64_t writes = engine.get_accesses(OP_TYPE::STORE);
+
+    // every size from one block up, every associativity from direct mapped to fully associative
+    std::cout << "size,assoc,sets,reads,read_misses,writes,write_misses,miss_rate" << std::endl;
+    for (uint64_t size = block_size; size <= max_size; size = size << 1)
+    {
+        for (uint64_t assoc = 1; assoc * block_size <= size; assoc = assoc << 1)
+        {
+            uint64_t sets = size / block_size / assoc;
+            unsigned set_bits = __builtin_ctzll(sets);
+
+            uint64_t read_misses = engine.get_misses(set_bits, assoc, OP_TYPE::LOAD);
+            uint64_t write_misses = engine.get_misses(set_bits, assoc, OP_TYPE::STORE);
+            float miss_rate = (read_misses + write_misses) / (float) (reads + writes);
+
+            std::cout << size << "," << assoc << "," << sets << "," << reads << "," << read_misses << ","
+                      << writes << "," << write_misses << "," << std::setprecision(4) << miss_rate << std::endl;
+        }
+    }
+
+    return 0;
+}
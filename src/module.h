@@ -9,6 +9,7 @@
 
 // standard includes
 #include <string>
+#include <cstddef>
 
 // local includes
 #include <common.h>
@@ -62,12 +63,12 @@ class module : public base
             {   
                 ifc_next = ifc;
                 if (ifc != nullptr) {
-                    log.log(this, verbose::DEBUG, "Connecting " + ifc->get_name() + " as next level");
+                    log.log<verbose::DEBUG>(this, "Connecting %s as next level", ifc->get_name());
                     ifc->mk_prev_connection(this);
                 } 
             }
             else {
-                log.log(this, verbose::DEBUG, "Connection to next level already made! Refusing connection");
+                log.log<verbose::DEBUG>(this, "Connection to next level already made! Refusing connection");
             }
         }
 
@@ -80,11 +81,11 @@ class module : public base
             {
                 ifc_prev = ifc;
                 if (ifc != nullptr) {
-                    log.log(this, verbose::DEBUG, "Connecting " + ifc->get_name() + " as previous level");
+                    log.log<verbose::DEBUG>(this, "Connecting %s as previous level", ifc->get_name());
                 }
             }
             else {
-                log.log(this, verbose::DEBUG, "Connection to previous level already made! Refusing connection");
+                log.log<verbose::DEBUG>(this, "Connection to previous level already made! Refusing connection");
             }
         }
 
@@ -111,7 +112,7 @@ class module : public base
         {
             if (ifc_next != nullptr)
             {
-                log.log(this, verbose::DEBUG, "Sending request packet " +  req->get_msg_str() + " --> " + ifc_next->get_name());
+                log.log<verbose::DEBUG>(this, "Sending request packet " MEM_REQ_FMT " --> %s", req->req_op_type, req->addr, ifc_next->get_name());
 
                 // push message ptr to next level
                 ifc_next -> req_ptr_prev = req;
@@ -136,7 +137,7 @@ class module : public base
             if (ifc_prev != nullptr)
             {
                 
-                log.log(this, verbose::DEBUG, "Sending response packet " + resp->get_msg_str() + " --> " + ifc_prev->get_name());
+                log.log<verbose::DEBUG>(this, "Sending response packet " RESP_MSG_FMT " --> %s", resp->ready, resp->addr, ifc_prev->get_name());
 
                 // push resp message to previous level
                 ifc_prev -> resp_ptr_next = resp;
@@ -156,6 +157,35 @@ class module : public base
             }
         }
 
+        // batch interfaces
+
+        /**
+         * @details Send a batch of requests to the next level in one call
+         */
+        virtual void put_batch_to_next(mem_req* reqs, size_t num)
+        {
+            if (ifc_next != nullptr)
+            {
+                log.log<verbose::DEBUG>(this, "Sending batch of %lu requests --> %s", num, ifc_next->get_name());
+
+                ifc_next -> get_batch_frm_prev(reqs, num);
+            }
+        }
+
+        /**
+         * @details Accept a batch of requests from the previous level. Modules without a batch path
+         * take them one at a time. The sender does not wait for responses of a batch
+         */
+        virtual void get_batch_frm_prev(mem_req* reqs, size_t num)
+        {
+            for (size_t i = 0; i < num; i++)
+            {
+                req_ptr_prev = &reqs[i];
+                get_frm_prev();
+            }
+            req_ptr_prev = nullptr;
+        }
+
         virtual void print()
         {
 
@@ -0,0 +1,407 @@
+/**
+ * @file multicore.cpp
+ * @details This file contains definitions of the multi-core simulation with a MESI directory
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "multicore.h"
+
+#include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cmath>
+
+#include <hierarchy.h>
+
+multicore_sim::multicore_sim(const sim_config& cfg, const std::vector<std::string>& trace_paths, uint64_t quantum,
+    const logger& log) :
+    base("Multi-core simulation"),
+    _log(log),
+    _quantum(quantum == 0 ? 1 : quantum < MAX_QUANTUM ? quantum : MAX_QUANTUM),
+    _block_bits((unsigned) std::log2(cfg.l1_block_size)),
+    _mem_traffic(0),
+    _num_quanta(0)
+{
+    for (size_t i = 0; i < trace_paths.size() && i < MAX_CORES; i++)
+    {
+        std::unique_ptr<core> c(new core());
+        c->trace_path = trace_paths[i];
+        c->status = TRACE_STATUS::VALID;
+        c->l1.reset(new cache("L1 of core " + std::to_string(i), cfg.l1_size, cfg.l1_assoc, cfg.l1_block_size, 0,
+            _log, &c->l1_counters, cfg.repl_policy, cfg.repl_seed));
+        c->l1_counters.attach_cache(c->l1.get());
+        c->reqs.resize(_quantum);
+
+        _cores.push_back(std::move(c));
+    }
+
+    // L2 blocks are 16 bytes, as in a single run
+    if (cfg.l2_size != 0)
+    {
+        _l2.reset(new cache("L2", cfg.l2_size, cfg.l2_assoc, 16, 0, _log, &_l2_counters, cfg.repl_policy, cfg.repl_seed));
+        _l2_counters.attach_cache(_l2.get());
+    }
+}
+
+bool multicore_sim::run_core(core& c)
+{
+    c.events.clear();
+
+    size_t count = 0;
+    while (count < _quantum && (c.status = c.trace->next(c.reqs[count])) == TRACE_STATUS::VALID) {
+        count++;
+    }
+
+    std::visit([&](auto& repl)
+    {
+        using POLICY = std::decay_t<decltype(repl)>;
+        cache_level<dynamic_geometry, POLICY> level(*c.l1);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const mem_req& req = c.reqs[i];
+            uint32_t pos = (uint32_t) i;
+
+            // a write to a clean copy needs it exclusive, which only the directory knows
+            bool is_dirty = false;
+            bool is_clean_write = req.req_op_type == OP_TYPE::STORE && c.l1->probe(req.addr, is_dirty) && !is_dirty;
+
+            const access_result& res = level.access(req);
+            if (res.hit)
+            {
+                if (is_clean_write) {
+                    c.events.push_back({pos, COH_REQ::UPGRADE, req.addr});
+                }
+                continue;
+            }
+
+            // a writeback always goes out before the fetch
+            if (res.evicted) {
+                c.events.push_back({pos, COH_REQ::PUT_M, res.evict_addr});
+            }
+            if (res.filled) {
+                c.events.push_back({pos, req.req_op_type == OP_TYPE::STORE ? COH_REQ::GET_M : COH_REQ::GET_S, res.fill_addr});
+            }
+        }
+    }, c.l1->get_repl_policy());
+
+    return c.status == TRACE_STATUS::VALID;
+}
+
+void multicore_sim::resolve()
+{
+    _l2_reqs.clear();
+
+    // merge the logs by record, then by core
+    std::vector<size_t> next(_cores.size(), 0);
+    while (true)
+    {
+        int idx = -1;
+        for (size_t i = 0; i < _cores.size(); i++)
+        {
+            const std::vector<coh_event>& events = _cores[i]->events;
+            if (next[i] < events.size() && (idx < 0 || events[next[i]].pos < _cores[idx]->events[next[idx]].pos)) {
+                idx = (int) i;
+            }
+        }
+        if (idx < 0) {
+            break;
+        }
+
+        serve((unsigned) idx, _cores[idx]->events[next[idx]]);
+        next[idx]++;
+    }
+
+    if (_l2 == nullptr)
+    {
+        _mem_traffic += _l2_reqs.size();
+        return;
+    }
+
+    // L2 runs the requests of the quantum as one batch, whatever it sends on goes to memory
+    _mem_reqs.clear();
+    std::visit([&](auto& repl)
+    {
+        using POLICY = std::decay_t<decltype(repl)>;
+        cache_level<dynamic_geometry, POLICY>(*_l2).access_batch(_l2_reqs.data(), _l2_reqs.size(), _mem_reqs);
+    }, _l2->get_repl_policy());
+
+    _mem_traffic += _mem_reqs.size();
+}
+
+void multicore_sim::serve(unsigned idx, const coh_event& ev)
+{
+    core& c = *_cores[idx];
+    perf_counters::coherence_counters& coh = c.coh_counters;
+    unsigned block = ev.addr >> _block_bits;
+    uint64_t self = 1ull << idx;
+
+    if (ev.type == COH_REQ::PUT_M)
+    {
+        _l2_reqs.emplace_back(OP_TYPE::STORE, ev.addr);
+
+        auto it = _directory.find(block);
+        if (it != _directory.end())
+        {
+            it->second.sharers &= ~self;
+            if (it->second.owner == (int) idx) {
+                it->second.owner = -1;
+            }
+            if (it->second.sharers == 0) {
+                _directory.erase(it);
+            }
+        }
+        return;
+    }
+
+    dir_entry& entry = _directory.emplace(block, dir_entry{0, -1}).first->second;
+
+    // the copy an upgrade wrote may be gone by now, evicted later in the quantum or invalidated earlier in
+    // this phase, the upgrade still happened at its record
+    switch (ev.type)
+    {
+        case COH_REQ::GET_S:
+        {
+            coh.read_reqs++;
+
+            // a modified copy elsewhere is written back and shared, it supplies the data
+            bool is_transfer = false;
+            if (entry.owner >= 0 && entry.owner != (int) idx)
+            {
+                if (_cores[entry.owner]->l1->downgrade(ev.addr))
+                {
+                    coh.downgrades++;
+                    coh.transfers++;
+                    _l2_reqs.emplace_back(OP_TYPE::STORE, ev.addr);
+                    is_transfer = true;
+                }
+                entry.owner = -1;
+            }
+            if (!is_transfer) {
+                _l2_reqs.emplace_back(OP_TYPE::LOAD, ev.addr);
+            }
+
+            prune(entry, ev.addr, idx);
+            if ((entry.sharers & ~self) == 0) {
+                coh.exclusive_fills++;
+            }
+            entry.sharers |= self;
+            break;
+        }
+        case COH_REQ::GET_M:
+        {
+            coh.write_reqs++;
+
+            if (invalidate_others(entry, ev.addr, idx)) {
+                coh.transfers++;
+            }
+            else {
+                _l2_reqs.emplace_back(OP_TYPE::LOAD, ev.addr);
+            }
+
+            entry.sharers = self;
+            entry.owner = (int) idx;
+            break;
+        }
+        case COH_REQ::UPGRADE:
+        {
+            prune(entry, ev.addr, idx);
+            if ((entry.sharers & ~self) != 0)
+            {
+                coh.upgrades++;
+                invalidate_others(entry, ev.addr, idx);
+            }
+            else {
+                coh.silent_upgrades++;
+            }
+
+            entry.sharers = self;
+            entry.owner = (int) idx;
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+void multicore_sim::prune(dir_entry& entry, unsigned addr, unsigned idx)
+{
+    uint64_t others = entry.sharers & ~(1ull << idx);
+    while (others != 0)
+    {
+        unsigned s = __builtin_ctzll(others);
+        others &= others - 1;
+
+        bool is_dirty = false;
+        if (!_cores[s]->l1->probe(addr, is_dirty))
+        {
+            entry.sharers &= ~(1ull << s);
+            if (entry.owner == (int) s) {
+                entry.owner = -1;
+            }
+        }
+    }
+}
+
+bool multicore_sim::invalidate_others(dir_entry& entry, unsigned addr, unsigned idx)
+{
+    perf_counters::coherence_counters& coh = _cores[idx]->coh_counters;
+
+    bool is_modified = false;
+    uint64_t others = entry.sharers & ~(1ull << idx);
+    while (others != 0)
+    {
+        unsigned s = __builtin_ctzll(others);
+        others &= others - 1;
+
+        bool was_dirty = false;
+        if (_cores[s]->l1->invalidate(addr, was_dirty))
+        {
+            coh.invalidations++;
+            is_modified |= was_dirty;
+        }
+    }
+
+    return is_modified;
+}
+
+bool multicore_sim::run()
+{
+    for (auto& c : _cores)
+    {
+        c->trace.reset(new trace_reader(c->trace_path));
+        if (!c->trace->is_open())
+        {
+            _log.log(this, verbose::FATAL, c->trace_path + ": Unable to find file");
+            return false;
+        }
+    }
+
+    unsigned num_cores = _cores.size();
+    std::vector<char> is_active(num_cores, 1);
+
+    // cores wait for the next quantum, the directory for every core to finish it
+    std::mutex lock;
+    std::condition_variable start_cv;
+    std::condition_variable done_cv;
+    uint64_t generation = 0;
+    unsigned num_done = 0;
+    bool is_stopping = false;
+
+    auto worker = [&](unsigned idx)
+    {
+        uint64_t seen = 0;
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> guard(lock);
+                start_cv.wait(guard, [&]() { return is_stopping || generation != seen; });
+                if (is_stopping) {
+                    return;
+                }
+                seen = generation;
+            }
+
+            if (is_active[idx]) {
+                is_active[idx] = run_core(*_cores[idx]);
+            }
+            else {
+                _cores[idx]->events.clear();
+            }
+
+            std::lock_guard<std::mutex> guard(lock);
+            if (++num_done == num_cores) {
+                done_cv.notify_one();
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned idx = 0; idx < num_cores; idx++) {
+        threads.emplace_back(worker, idx);
+    }
+
+    bool is_any_active = num_cores > 0;
+    while (is_any_active)
+    {
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            num_done = 0;
+            generation++;
+        }
+        start_cv.notify_all();
+
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            done_cv.wait(guard, [&]() { return num_done == num_cores; });
+        }
+
+        resolve();
+        _num_quanta++;
+
+        is_any_active = false;
+        for (char active : is_active) {
+            is_any_active |= active != 0;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        is_stopping = true;
+    }
+    start_cv.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    bool is_ok = true;
+    for (auto& c : _cores)
+    {
+        if (c->status != TRACE_STATUS::END_OF_TRACE)
+        {
+            _log.log(this, verbose::FATAL, c->trace_path + ": Invalid record at line " + std::to_string(c->trace->get_line()));
+            is_ok = false;
+        }
+    }
+
+    _log.log(this, verbose::INFO, std::to_string(num_cores) + " cores ran " + std::to_string(_num_quanta) + " quanta of " +
+        std::to_string(_quantum) + " records");
+
+    return is_ok;
+}
+
+void multicore_sim::print_results()
+{
+    std::cout << "===== Simulation results (multi-core) =====" << std::endl;
+
+    for (size_t i = 0; i < _cores.size(); i++)
+    {
+        const core& c = *_cores[i];
+        const perf_counters::cache_counters& l1 = c.l1_counters;
+        const perf_counters::coherence_counters& coh = c.coh_counters;
+
+        std::cout << " core " << i << ":\t" << c.trace_path << std::endl;
+        std::cout << "  a. number of L1 reads:\t" << l1.num_reads << std::endl;
+        std::cout << "  b. number of L1 read misses:\t" << l1.read_misses << std::endl;
+        std::cout << "  c. number of L1 writes:\t" << l1.num_writes << std::endl;
+        std::cout << "  d. number of L1 write misses:\t" << l1.write_misses << std::endl;
+        std::cout << "  e. number of writebacks from L1:\t" << l1.num_writebacks << std::endl;
+        std::cout << "  f. number of shared requests:\t" << coh.read_reqs << std::endl;
+        std::cout << "  g. number of exclusive fills:\t" << coh.exclusive_fills << std::endl;
+        std::cout << "  h. number of modified requests:\t" << coh.write_reqs << std::endl;
+        std::cout << "  i. number of upgrades:\t" << coh.upgrades << std::endl;
+        std::cout << "  j. number of silent upgrades:\t" << coh.silent_upgrades << std::endl;
+        std::cout << "  k. number of invalidations sent:\t" << coh.invalidations << std::endl;
+        std::cout << "  l. number of downgrades caused:\t" << coh.downgrades << std::endl;
+        std::cout << "  m. number of cache-to-cache transfers:\t" << coh.transfers << std::endl;
+    }
+
+    std::cout << " shared L2:" << std::endl;
+    std::cout << "  a. number of L2 reads:\t" << _l2_counters.num_reads << std::endl;
+    std::cout << "  b. number of L2 read misses:\t" << _l2_counters.read_misses << std::endl;
+    std::cout << "  c. number of L2 writes:\t" << _l2_counters.num_writes << std::endl;
+    std::cout << "  d. number of L2 write misses:\t" << _l2_counters.write_misses << std::endl;
+    std::cout << "  e. number of writebacks from L2:\t" << _l2_counters.num_writebacks << std::endl;
+    std::cout << " total memory traffic:\t" << _mem_traffic << std::endl;
+}
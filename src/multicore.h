@@ -0,0 +1,164 @@
+/**
+ * @file multicore.h
+ * @details This file contains the simulation of several cores with private L1s, a shared L2 and a
+ * MESI directory
+ *
+ * Cores run in quanta of trace records, in two phases. In the first, every core runs its next records
+ * through its private L1 on a thread of its own and logs what the L1 needs from the rest of the
+ * system: a shared or a modified copy for each miss, the writeback of each dirty line it evicts and
+ * an upgrade for each write to a clean line. In the second, the directory serves the logs of all cores
+ * on one thread, in the order of the records within the quantum and by core for the same record. It
+ * reads and writes the shared L2 and invalidates or downgrades the copies other cores hold. A core
+ * thus sees the writes of other cores at the end of the quantum they were made in, and the
+ * interleaving depends on the quantum only, never on thread timing.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <unordered_map>
+#include <cstdint>
+
+// local includes
+#include <base.h>
+#include <cache.h>
+#include <perf_counters.h>
+#include <trace_reader.h>
+#include <sweep.h>
+
+/**
+ * @details Requests an L1 sends to the directory
+ */
+enum COH_REQ
+{
+    GET_S,
+    GET_M,
+    UPGRADE,
+    PUT_M
+};
+
+/**
+ * @details One request of an L1, pos is the record within the quantum causing it
+ */
+struct coh_event
+{
+    uint32_t pos;
+    COH_REQ type;
+    unsigned addr;
+};
+
+/**
+ * @details Simulates one trace per core through private L1s and a shared L2 kept coherent with MESI.
+ * Lines of an L1 are modified when dirty; whether a clean line is exclusive or shared is only known
+ * to the directory
+ */
+class multicore_sim : public base
+{
+    private:
+        // one core and its private L1
+        struct core
+        {
+            std::string trace_path;
+            std::unique_ptr<trace_reader> trace;
+            TRACE_STATUS status;
+
+            std::unique_ptr<cache> l1;
+            perf_counters::cache_counters l1_counters;
+            perf_counters::coherence_counters coh_counters;
+
+            // records and directory requests of the current quantum, reused from quantum to quantum
+            std::vector<mem_req> reqs;
+            std::vector<coh_event> events;
+        };
+
+        // directory entry of one block held by some L1
+        struct dir_entry
+        {
+            // cores that may hold a copy, copies dropped by an eviction are only found out on the next use
+            uint64_t sharers;
+
+            // core holding the modified copy, -1 if none
+            int owner;
+        };
+
+        logger _log;
+        uint64_t _quantum;
+        unsigned _block_bits;
+
+        std::vector<std::unique_ptr<core>> _cores;
+
+        std::unique_ptr<cache> _l2;
+        perf_counters::cache_counters _l2_counters;
+
+        std::unordered_map<unsigned, dir_entry> _directory;
+
+        // requests for L2 and memory made while serving a quantum, in order
+        std::vector<mem_req> _l2_reqs;
+        std::vector<mem_req> _mem_reqs;
+        uint64_t _mem_traffic;
+
+        uint64_t _num_quanta;
+
+        /**
+         * @details First phase of a quantum for one core, false once its trace is done
+         */
+        bool run_core(core& c);
+
+        /**
+         * @details Second phase of a quantum: serve the requests of every core in order
+         */
+        void resolve();
+
+        /**
+         * @details Serve one request of core idx
+         */
+        void serve(unsigned idx, const coh_event& ev);
+
+        /**
+         * @details Drop the cores from the sharers of entry that no longer hold block addr, except idx
+         */
+        void prune(dir_entry& entry, unsigned addr, unsigned idx);
+
+        /**
+         * @details Invalidate the copies of every core but idx, true if one of them was modified
+         */
+        bool invalidate_others(dir_entry& entry, unsigned addr, unsigned idx);
+
+    public:
+
+        /**
+         * @details Cores reading the traces at trace_paths, with L1s and L2 configured as cfg, which must
+         * not have a victim cache. quantum is the number of records a core runs between directory phases
+         */
+        multicore_sim(const sim_config& cfg, const std::vector<std::string>& trace_paths, uint64_t quantum, const logger& log);
+
+        /**
+         * @details Run every trace to its end, one thread per core. False if a trace could not be read
+         */
+        bool run();
+
+        /**
+         * @details Print the counters of every core, L2 and memory
+         */
+        void print_results();
+
+        /**
+         * @details Maximum number of cores
+         */
+        static const unsigned MAX_CORES = 64;
+
+        /**
+         * @details Largest quantum: every core holds the records of a quantum and its directory
+         * requests, and records are numbered within it by coh_event::pos
+         */
+        static const uint64_t MAX_QUANTUM = 1 << 20;
+};
+
+static_assert(multicore_sim::MAX_QUANTUM <= UINT32_MAX, "records of a quantum are numbered with 32 bits");
+
+#endif // MULTICORE_H
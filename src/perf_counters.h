@@ -8,32 +8,73 @@
 #define PERF_COUNTERS_H
 
 #include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
 #include <module.h>
 
 namespace perf_counters
 {
+    /**
+     * @details Accesses of one set. A victim cache hit is a miss of the set, and writebacks are
+     * those the misses of the set caused, out of the victim cache too
+     */
+    struct set_counters
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t writebacks;
+
+        // misses by class, when they are classified
+        uint64_t compulsory;
+        uint64_t capacity;
+        uint64_t conflict;
+    };
+
     struct cache_counters 
     {
         module* cache_ptr;    
 
-        unsigned num_reads;
-        unsigned read_misses;
-        unsigned num_writes;
-        unsigned write_misses;
-        unsigned num_swap_req;
-        unsigned num_swaps;
-        unsigned num_writebacks;
+        uint64_t num_reads;
+        uint64_t read_misses;
+        uint64_t num_writes;
+        uint64_t write_misses;
+        uint64_t num_swap_req;
+        uint64_t num_swaps;
+        uint64_t num_writebacks;
+
+        // misses by class, when the cache classifies them
+        bool is_classified;
+        uint64_t compulsory_misses;
+        uint64_t capacity_misses;
+        uint64_t conflict_misses;
+
+        // per set counters, empty unless the cache turned them on
+        std::vector<set_counters> sets;
 
         cache_counters()
         {
-            // reset counters
+            reset();
+            cache_ptr = nullptr;
+            is_classified = false;
+        }
+
+        /**
+         * @details Zero every counter, the cache stays attached
+         */
+        void reset()
+        {
             num_reads = 0;
             read_misses = 0;
             num_writes = 0;
             write_misses = 0;
             num_swap_req = 0;
+            num_swaps = 0;
             num_writebacks = 0;
-            cache_ptr = nullptr;
+            compulsory_misses = 0;
+            capacity_misses = 0;
+            conflict_misses = 0;
+            std::fill(sets.begin(), sets.end(), set_counters{0, 0, 0, 0, 0, 0});
         }
 
         void attach_cache(module* ptr){
@@ -50,6 +91,43 @@ namespace perf_counters
             std::cout << "Number of swaps: " << num_swaps << std::endl;
         }
     };
+
+    /**
+     * @details Coherence traffic of one core's L1 with a MESI directory, counted for the core
+     * making the request
+     */
+    struct coherence_counters
+    {
+        // misses asking for a shared copy and for a modified copy
+        uint64_t read_reqs;
+        uint64_t write_reqs;
+
+        // writes to a shared copy that invalidated other copies, and to an exclusive copy that did not
+        uint64_t upgrades;
+        uint64_t silent_upgrades;
+
+        // read misses filled in the exclusive state
+        uint64_t exclusive_fills;
+
+        // copies of other cores invalidated, modified copies of other cores downgraded to shared
+        uint64_t invalidations;
+        uint64_t downgrades;
+
+        // misses served by the modified copy of another core instead of L2
+        uint64_t transfers;
+
+        coherence_counters()
+        {
+            read_reqs = 0;
+            write_reqs = 0;
+            upgrades = 0;
+            silent_upgrades = 0;
+            exclusive_fills = 0;
+            invalidations = 0;
+            downgrades = 0;
+            transfers = 0;
+        }
+    };
 }
 
 
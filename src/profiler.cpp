@@ -0,0 +1,350 @@
+/**
+ * @file profiler.cpp
+ * @details This file contains definitions of the stage profiler
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "profiler.h"
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstring>
+#include <cerrno>
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/**
+ * @details Time stamp counter, nanoseconds of the clock where there is none
+ */
+static inline uint64_t read_ticks()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// perf event of every PROF_EVENT
+static const uint64_t PROF_EVENT_CONFIGS[NUM_PROF_EVENTS] = {
+    PERF_COUNT_HW_CPU_CYCLES,
+    PERF_COUNT_HW_INSTRUCTIONS,
+    PERF_COUNT_HW_CACHE_MISSES,
+    PERF_COUNT_HW_BRANCH_MISSES
+};
+
+hw_counters::hw_counters()
+{
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++)
+    {
+        _fds[event] = -1;
+        _pages[event] = nullptr;
+    }
+
+    // one group led by cycles, so the events are scheduled together
+    int leader = -1;
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = PROF_EVENT_CONFIGS[event];
+        attr.disabled = leader < 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        int fd = syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+        if (fd < 0)
+        {
+            // without cycles there is no group to join
+            if (leader < 0)
+            {
+                _err = std::string("perf_event_open: ") + std::strerror(errno);
+                return;
+            }
+            continue;
+        }
+        _fds[event] = fd;
+
+        if (leader < 0) {
+            leader = fd;
+        }
+
+        // the event page tells whether rdpmc may be used
+        void* page = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ, MAP_SHARED, fd, 0);
+        if (page != MAP_FAILED) {
+            _pages[event] = static_cast<perf_event_mmap_page*>(page);
+        }
+    }
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+hw_counters::~hw_counters()
+{
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++)
+    {
+        if (_pages[event] != nullptr) {
+            munmap(_pages[event], sysconf(_SC_PAGESIZE));
+        }
+        if (_fds[event] >= 0) {
+            close(_fds[event]);
+        }
+    }
+}
+
+bool hw_counters::is_any_open() const
+{
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++)
+    {
+        if (is_open(event)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool hw_counters::is_rdpmc() const
+{
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++)
+    {
+        if (is_open(event) && (_pages[event] == nullptr || !_pages[event]->cap_user_rdpmc)) {
+            return false;
+        }
+    }
+    return is_any_open();
+}
+
+uint64_t hw_counters::read_event(unsigned event) const
+{
+#if defined(__x86_64__) || defined(__i386__)
+    // the kernel updates the page under a sequence count
+    const volatile perf_event_mmap_page* page = _pages[event];
+    if (page != nullptr && page->cap_user_rdpmc)
+    {
+        uint32_t seq;
+        uint32_t idx;
+        uint64_t count;
+        do
+        {
+            seq = page->lock;
+            __asm__ __volatile__("" ::: "memory");
+
+            idx = page->index;
+            count = page->offset;
+            if (idx != 0)
+            {
+                unsigned width = page->pmc_width;
+                uint64_t pmc = __rdpmc(idx - 1);
+                count += static_cast<uint64_t>(static_cast<int64_t>(pmc << (64 - width)) >> (64 - width));
+            }
+
+            __asm__ __volatile__("" ::: "memory");
+        } while (page->lock != seq);
+
+        // an event that is not on a counter right now is read through the kernel
+        if (idx != 0) {
+            return count;
+        }
+    }
+#endif
+
+    uint64_t val = 0;
+    if (::read(_fds[event], &val, sizeof(val)) != sizeof(val)) {
+        return 0;
+    }
+    return val;
+}
+
+void hw_counters::read(uint64_t vals[NUM_PROF_EVENTS]) const
+{
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++) {
+        vals[event] = is_open(event) ? read_event(event) : 0;
+    }
+}
+
+profiler::profiler() :
+    base("Profiler"),
+    _is_hw_on(false),
+    _last_ticks(0),
+    _sample_ticks(0)
+{
+    _is_hw_on = _hw.is_any_open();
+
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++)
+    {
+        _last_counts[event] = 0;
+        _sample_counts[event] = 0;
+    }
+
+    calibrate();
+
+    _start_ticks = read_ticks();
+    _start_time = std::chrono::steady_clock::now();
+}
+
+unsigned profiler::add_stage(const std::string& name)
+{
+    stage s;
+    s.name = name;
+    s.ticks = 0;
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++) {
+        s.counts[event] = 0;
+    }
+
+    _stages.push_back(s);
+    return _stages.size() - 1;
+}
+
+void profiler::charge()
+{
+    uint64_t ticks = read_ticks();
+    uint64_t counts[NUM_PROF_EVENTS] = {};
+    if (_is_hw_on) {
+        _hw.read(counts);
+    }
+
+    if (!_stack.empty())
+    {
+        stage& s = _stages[_stack.back()];
+
+        uint64_t delta = ticks - _last_ticks;
+        s.ticks += delta > _sample_ticks ? delta - _sample_ticks : 0;
+
+        for (unsigned event = 0; event < NUM_PROF_EVENTS; event++)
+        {
+            delta = counts[event] - _last_counts[event];
+            s.counts[event] += delta > _sample_counts[event] ? delta - _sample_counts[event] : 0;
+        }
+    }
+
+    _last_ticks = ticks;
+    std::memcpy(_last_counts, counts, sizeof(counts));
+}
+
+void profiler::calibrate()
+{
+    const unsigned NUM_SAMPLES = 1000;
+
+    // samples with no stage entered are charged nowhere
+    charge();
+    uint64_t first_ticks = _last_ticks;
+    uint64_t first_counts[NUM_PROF_EVENTS];
+    std::memcpy(first_counts, _last_counts, sizeof(first_counts));
+
+    for (unsigned i = 0; i < NUM_SAMPLES; i++) {
+        charge();
+    }
+
+    _sample_ticks = (_last_ticks - first_ticks) / NUM_SAMPLES;
+    for (unsigned event = 0; event < NUM_PROF_EVENTS; event++) {
+        _sample_counts[event] = (_last_counts[event] - first_counts[event]) / NUM_SAMPLES;
+    }
+}
+
+/**
+ * @details Ratio as text, n/a when there is nothing to divide by
+ */
+static std::string ratio_str(double num, double den, double scale)
+{
+    if (den <= 0.0) {
+        return "n/a";
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2) << num * scale / den;
+    return out.str();
+}
+
+void profiler::print(uint64_t num_accesses) const
+{
+    // the time stamp counter runs at a fixed rate, the clock tells which
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - _start_time;
+    uint64_t elapsed_ticks = read_ticks() - _start_ticks;
+    double secs_per_tick = elapsed_ticks > 0 ? elapsed.count() / elapsed_ticks : 0.0;
+
+    uint64_t total_ticks = 0;
+    for (const stage& s : _stages) {
+        total_ticks += s.ticks;
+    }
+    double total_secs = total_ticks * secs_per_tick;
+
+    std::cout << std::endl << "===== Simulator profile =====" << std::endl;
+    if (!_is_hw_on) {
+        std::cout << " hardware counters unavailable (" << _hw.get_error() << "), stages are timed only" << std::endl;
+    }
+    else if (!_hw.is_rdpmc()) {
+        std::cout << " hardware counters are read through the kernel, which slows down every stage switch" << std::endl;
+    }
+
+    for (const stage& s : _stages)
+    {
+        double secs = s.ticks * secs_per_tick;
+        std::cout << " " << s.name << ":\t" << std::fixed << std::setprecision(3) << secs << " s\t"
+                  << ratio_str(s.ticks, total_ticks, 100.0) << "%\t"
+                  << ratio_str(secs, num_accesses, 1e9) << " ns/access";
+
+        if (_is_hw_on)
+        {
+            const char* names[NUM_PROF_EVENTS] = {"cycles/access", "IPC", "LLC misses/1k accesses", "branch misses/1k accesses"};
+            std::string vals[NUM_PROF_EVENTS] = {
+                ratio_str(s.counts[CYCLES], num_accesses, 1.0),
+                ratio_str(s.counts[INSTRUCTIONS], s.counts[CYCLES], 1.0),
+                ratio_str(s.counts[LLC_MISSES], num_accesses, 1000.0),
+                ratio_str(s.counts[BRANCH_MISSES], num_accesses, 1000.0)
+            };
+            for (unsigned event = 0; event < NUM_PROF_EVENTS; event++) {
+                std::cout << "\t" << (_hw.is_open(event) ? vals[event] : "n/a") << " " << names[event];
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    std::cout << " total:\t" << std::fixed << std::setprecision(3) << total_secs << " s" << std::endl;
+    std::cout << " accesses per second:\t" << ratio_str(num_accesses, total_secs, 1e-6) << " M" << std::endl;
+    std::cout << std::defaultfloat;
+}
+
+prof_probe::prof_probe(profiler& prof, unsigned prev_stage, const std::string& name, const logger& log) :
+    module(name + " probe", log),
+    _prof(&prof),
+    _prev_stage(prev_stage),
+    _stage(prof.add_stage(name))
+{
+}
+
+void prof_probe::get_frm_prev()
+{
+    if (ifc_prev != nullptr)
+    {
+        prof_scope scope(_prof, _stage);
+        put_to_next(req_ptr_prev);
+    }
+}
+
+void prof_probe::get_frm_next()
+{
+    // responses are work of the module they go back to
+    if (ifc_prev != nullptr)
+    {
+        prof_scope scope(_prof, _prev_stage);
+        put_to_prev(resp_ptr_next);
+    }
+}
+
+void prof_probe::get_batch_frm_prev(mem_req* reqs, size_t num)
+{
+    prof_scope scope(_prof, _stage);
+    put_batch_to_next(reqs, num);
+}
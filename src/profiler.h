@@ -0,0 +1,230 @@
+/**
+ * @file profiler.h
+ * @details This file contains an opt-in profiler of the simulator's own stages
+ *
+ * Time is taken with the time stamp counter and, where perf events are available, with hardware
+ * counters of the simulating thread read in user space. Stages nest: entering one pauses the stage
+ * it was entered from, so each stage is charged its own work only.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+
+// local includes
+#include <module.h>
+
+struct perf_event_mmap_page;
+
+/**
+ * @details Hardware events counted per stage
+ */
+enum PROF_EVENT
+{
+    CYCLES,
+    INSTRUCTIONS,
+    LLC_MISSES,
+    BRANCH_MISSES,
+    NUM_PROF_EVENTS
+};
+
+/**
+ * @details Hardware counters of the calling thread. Counters are read with rdpmc where the kernel
+ * allows it and with a read of the event otherwise. Events the machine does not have stay closed
+ */
+class hw_counters
+{
+    private:
+        int _fds[NUM_PROF_EVENTS];
+        perf_event_mmap_page* _pages[NUM_PROF_EVENTS];
+
+        // why the counters could not be opened
+        std::string _err;
+
+        uint64_t read_event(unsigned event) const;
+
+    public:
+        hw_counters();
+        ~hw_counters();
+
+        hw_counters(const hw_counters&) = delete;
+        hw_counters& operator=(const hw_counters&) = delete;
+
+        /**
+         * @details Whether event is counted
+         */
+        bool is_open(unsigned event) const {
+            return _fds[event] >= 0;
+        }
+
+        /**
+         * @details Whether any event is counted
+         */
+        bool is_any_open() const;
+
+        /**
+         * @details Whether every open event is read in user space
+         */
+        bool is_rdpmc() const;
+
+        const std::string& get_error() const {
+            return _err;
+        }
+
+        /**
+         * @details Current value of every open event, 0 for the others
+         */
+        void read(uint64_t vals[NUM_PROF_EVENTS]) const;
+};
+
+/**
+ * @details Ticks and hardware counts charged to named stages
+ */
+class profiler : public base
+{
+    private:
+        struct stage
+        {
+            std::string name;
+            uint64_t ticks;
+            uint64_t counts[NUM_PROF_EVENTS];
+        };
+
+        std::vector<stage> _stages;
+
+        // stages entered and not left yet, innermost last
+        std::vector<unsigned> _stack;
+
+        hw_counters _hw;
+        bool _is_hw_on;
+
+        // sample of the last stage switch
+        uint64_t _last_ticks;
+        uint64_t _last_counts[NUM_PROF_EVENTS];
+
+        // what taking a sample costs itself, taken off every charge
+        uint64_t _sample_ticks;
+        uint64_t _sample_counts[NUM_PROF_EVENTS];
+
+        // time stamp counter against the clock over the life of the profiler
+        uint64_t _start_ticks;
+        std::chrono::steady_clock::time_point _start_time;
+
+        /**
+         * @details Take a sample and charge everything since the last one to the innermost stage
+         */
+        void charge();
+
+        /**
+         * @details Measure the cost of a sample
+         */
+        void calibrate();
+
+    public:
+
+        /**
+         * @details Profiler of the calling thread, with hardware counters where they are available
+         */
+        profiler();
+
+        /**
+         * @details Add a stage, returns its index
+         */
+        unsigned add_stage(const std::string& name);
+
+        /**
+         * @details Start charging stage idx, pausing the stage entered last
+         */
+        void enter(unsigned idx)
+        {
+            charge();
+            _stack.push_back(idx);
+        }
+
+        /**
+         * @details Stop charging the stage entered last and resume the one before
+         */
+        void leave()
+        {
+            charge();
+            _stack.pop_back();
+        }
+
+        /**
+         * @details Whether hardware counters are read, or only the time stamp counter
+         */
+        bool is_hw_on() const {
+            return _is_hw_on;
+        }
+
+        const hw_counters& get_hw_counters() const {
+            return _hw;
+        }
+
+        /**
+         * @details Print the breakdown by stage for num_accesses simulated accesses
+         */
+        void print(uint64_t num_accesses) const;
+};
+
+/**
+ * @details Charges its scope to a stage, does nothing without a profiler
+ */
+class prof_scope
+{
+    private:
+        profiler* _prof;
+
+    public:
+        prof_scope(profiler* prof, unsigned idx) : _prof(prof)
+        {
+            if (_prof != nullptr) {
+                _prof->enter(idx);
+            }
+        }
+
+        ~prof_scope()
+        {
+            if (_prof != nullptr) {
+                _prof->leave();
+            }
+        }
+
+        prof_scope(const prof_scope&) = delete;
+        prof_scope& operator=(const prof_scope&) = delete;
+};
+
+/**
+ * @details Sits in front of a module and charges the requests it handles to its stage, and the
+ * responses going back to the stage of the module before
+ */
+class prof_probe : public module
+{
+    private:
+        profiler* _prof;
+        unsigned _prev_stage;
+        unsigned _stage;
+
+    public:
+
+        /**
+         * @details Probe in front of the module named name, after the module charged to prev_stage
+         */
+        prof_probe(profiler& prof, unsigned prev_stage, const std::string& name, const logger& log);
+
+        unsigned get_stage() const {
+            return _stage;
+        }
+
+        void get_frm_prev();
+        void get_frm_next();
+        void get_batch_frm_prev(mem_req* reqs, size_t num);
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,585 @@
+/**
+ * @file repl_policy.h
+ * @details This file contains the replacement policies used by caches
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef REPL_POLICY_H
+#define REPL_POLICY_H
+
+// standard includes
+#include <vector>
+#include <string>
+#include <variant>
+#include <cstdint>
+#include <cstddef>
+
+// local includes
+#include <checkpoint.h>
+
+/**
+ * @details Replacement policies selectable for the main cache
+ */
+enum REPL_POLICY {
+    LRU,
+    PLRU,
+    SRRIP,
+    BRRIP,
+    FIFO,
+    RANDOM
+};
+
+/*
+ * Every policy provides the same interface, so the cache is written once against it:
+ *  on_hit(set, way)        a valid line was hit
+ *  on_fill(set, way)       a line received a new block
+ *  on_invalidate(set, way) a line was invalidated
+ *  victim(set)             line to replace in a full set
+ *  rank(set, way)          eviction order of a valid line for printing, 0 is replaced last
+ *  save(out), restore(in)  write and read back the policy state for a checkpoint
+ */
+
+/**
+ * @details True LRU kept as an intrusive doubly linked recency list per set.
+ * Only valid lines are on the list, most recently used at the head. Hits, fills,
+ * invalidations and victim selection are all constant time.
+ */
+class lru_policy
+{
+    private:
+        // list terminator and marker for lines not on any list
+        static const unsigned NONE = ~0u;
+        static const unsigned UNLINKED = ~0u - 1;
+
+        unsigned _assoc;
+
+        // per line links, indexed by set * assoc + way
+        std::vector<unsigned> _prev;
+        std::vector<unsigned> _next;
+
+        // per set ends of the list
+        std::vector<unsigned> _head;
+        std::vector<unsigned> _tail;
+
+        size_t line_idx(unsigned set, unsigned way) const {
+            return (size_t) set * _assoc + way;
+        }
+
+        void unlink(unsigned set, unsigned way)
+        {
+            size_t idx = line_idx(set, way);
+            unsigned prev = _prev[idx];
+            unsigned next = _next[idx];
+
+            if (prev == NONE) {
+                _head[set] = next;
+            } else {
+                _next[line_idx(set, prev)] = next;
+            }
+
+            if (next == NONE) {
+                _tail[set] = prev;
+            } else {
+                _prev[line_idx(set, next)] = prev;
+            }
+
+            _prev[idx] = UNLINKED;
+            _next[idx] = UNLINKED;
+        }
+
+        void push_front(unsigned set, unsigned way)
+        {
+            size_t idx = line_idx(set, way);
+            unsigned head = _head[set];
+
+            _prev[idx] = NONE;
+            _next[idx] = head;
+
+            if (head == NONE) {
+                _tail[set] = way;
+            } else {
+                _prev[line_idx(set, head)] = way;
+            }
+            _head[set] = way;
+        }
+
+        /**
+         * @details Make a line the most recently used one of its set
+         */
+        void touch(unsigned set, unsigned way)
+        {
+            if (_head[set] == way) {
+                return;
+            }
+            if (_prev[line_idx(set, way)] != UNLINKED) {
+                unlink(set, way);
+            }
+            push_front(set, way);
+        }
+
+    public:
+
+        /**
+         * @details Construct empty recency lists for num_sets sets of assoc ways
+         */
+        lru_policy(unsigned num_sets, unsigned assoc) :
+            _assoc(assoc),
+            _prev((size_t) num_sets * assoc, UNLINKED),
+            _next((size_t) num_sets * assoc, UNLINKED),
+            _head(num_sets, NONE),
+            _tail(num_sets, NONE)
+        {
+        }
+
+        /**
+         * @details Update on a hit to a valid line
+         */
+        void on_hit(unsigned set, unsigned way) {
+            touch(set, way);
+        }
+
+        /**
+         * @details Update when a line receives a new block
+         */
+        void on_fill(unsigned set, unsigned way) {
+            touch(set, way);
+        }
+
+        /**
+         * @details Drop a line that was invalidated
+         */
+        void on_invalidate(unsigned set, unsigned way)
+        {
+            if (_prev[line_idx(set, way)] != UNLINKED) {
+                unlink(set, way);
+            }
+        }
+
+        /**
+         * @details Least recently used valid line of a set, -1 if the set holds none
+         */
+        int victim(unsigned set) {
+            return _tail[set] == NONE ? -1 : (int) _tail[set];
+        }
+
+        /**
+         * @details Recency rank of a valid line, 0 for the most recently used one
+         */
+        unsigned rank(unsigned set, unsigned way) const
+        {
+            unsigned rank = 0;
+            for (unsigned cur = _head[set]; cur != NONE && cur != way; cur = _next[line_idx(set, cur)]) {
+                rank++;
+            }
+            return rank;
+        }
+
+        void save(ckpt_writer& out) const
+        {
+            out.put_vec(_prev);
+            out.put_vec(_next);
+            out.put_vec(_head);
+            out.put_vec(_tail);
+        }
+
+        bool restore(ckpt_reader& in)
+        {
+            in.get_vec(_prev);
+            in.get_vec(_next);
+            in.get_vec(_head);
+            return in.get_vec(_tail);
+        }
+};
+
+/**
+ * @details Tree pseudo-LRU. One bit per inner node of a binary tree over the ways of a set points
+ * towards the half holding the next victim. Associativities that are not a power of two use the
+ * next larger tree and never descend into the missing ways.
+ */
+class plru_policy
+{
+    private:
+        unsigned _assoc;
+
+        // ways covered by the tree, assoc rounded up to a power of two
+        unsigned _leaves;
+
+        // 64 bit words of tree bits per set
+        unsigned _words;
+
+        // node n of a set lives at bit n, the root is node 1
+        std::vector<uint64_t> _bits;
+
+        bool get_bit(unsigned set, unsigned node) const {
+            return (_bits[(size_t) set * _words + (node >> 6)] >> (node & 63)) & 1;
+        }
+
+        void put_bit(unsigned set, unsigned node, bool bit)
+        {
+            uint64_t& word = _bits[(size_t) set * _words + (node >> 6)];
+            word = (word & ~(1ull << (node & 63))) | ((uint64_t) bit << (node & 63));
+        }
+
+        /**
+         * @details Point all nodes on the path to a line away from it
+         */
+        void touch(unsigned set, unsigned way)
+        {
+            unsigned node = 1;
+            for (unsigned half = _leaves >> 1; half > 0; half = half >> 1)
+            {
+                bool is_right = way & half;
+
+                // victim goes to the other half
+                put_bit(set, node, !is_right);
+                node = 2 * node + is_right;
+            }
+        }
+
+    public:
+
+        /**
+         * @details Construct trees for num_sets sets of assoc ways
+         */
+        plru_policy(unsigned num_sets, unsigned assoc) : _assoc(assoc)
+        {
+            _leaves = 1;
+            while (_leaves < assoc) {
+                _leaves = _leaves << 1;
+            }
+            _words = (_leaves + 63) / 64;
+            _bits.assign((size_t) num_sets * _words, 0);
+        }
+
+        void on_hit(unsigned set, unsigned way) {
+            touch(set, way);
+        }
+
+        void on_fill(unsigned set, unsigned way) {
+            touch(set, way);
+        }
+
+        // invalid lines are refilled before any victim is asked for
+        void on_invalidate(unsigned, unsigned) {}
+
+        /**
+         * @details Follow the tree bits down to a line
+         */
+        int victim(unsigned set)
+        {
+            unsigned node = 1;
+            unsigned way = 0;
+            for (unsigned half = _leaves >> 1; half > 0; half = half >> 1)
+            {
+                bool is_right = get_bit(set, node);
+
+                // the right half may lie completely past the last way
+                if (way + half >= _assoc) {
+                    is_right = false;
+                }
+
+                way = way + (is_right ? half : 0);
+                node = 2 * node + is_right;
+            }
+            return way;
+        }
+
+        /**
+         * @details Number of tree bits on the path pointing towards the line
+         */
+        unsigned rank(unsigned set, unsigned way) const
+        {
+            unsigned rank = 0;
+            unsigned node = 1;
+            for (unsigned half = _leaves >> 1; half > 0; half = half >> 1)
+            {
+                bool is_right = way & half;
+                if (get_bit(set, node) == is_right) {
+                    rank++;
+                }
+                node = 2 * node + is_right;
+            }
+            return rank;
+        }
+
+        void save(ckpt_writer& out) const {
+            out.put_vec(_bits);
+        }
+
+        bool restore(ckpt_reader& in) {
+            return in.get_vec(_bits);
+        }
+};
+
+/**
+ * @details Re-reference interval prediction with 2 bit prediction values per line.
+ * Static RRIP inserts with a long re-reference interval, bimodal RRIP with a distant one and
+ * only every 32nd fill with a long one, which keeps thrashing working sets from flushing the cache.
+ */
+template <bool BIMODAL>
+class rrip_policy
+{
+    private:
+        static const uint8_t RRPV_MAX = 3;
+
+        // fills between two long interval insertions of bimodal RRIP
+        static const unsigned BIMODAL_THROTTLE = 32;
+
+        unsigned _assoc;
+
+        // prediction value per line, indexed by set * assoc + way
+        std::vector<uint8_t> _rrpv;
+
+        unsigned _fills;
+
+    public:
+
+        /**
+         * @details Construct prediction values for num_sets sets of assoc ways
+         */
+        rrip_policy(unsigned num_sets, unsigned assoc) :
+            _assoc(assoc),
+            _rrpv((size_t) num_sets * assoc, RRPV_MAX),
+            _fills(0)
+        {
+        }
+
+        void on_hit(unsigned set, unsigned way) {
+            _rrpv[(size_t) set * _assoc + way] = 0;
+        }
+
+        void on_fill(unsigned set, unsigned way)
+        {
+            uint8_t rrpv = RRPV_MAX - 1;
+            if (BIMODAL)
+            {
+                if (++_fills == BIMODAL_THROTTLE) {
+                    _fills = 0;
+                } else {
+                    rrpv = RRPV_MAX;
+                }
+            }
+            _rrpv[(size_t) set * _assoc + way] = rrpv;
+        }
+
+        void on_invalidate(unsigned set, unsigned way) {
+            _rrpv[(size_t) set * _assoc + way] = RRPV_MAX;
+        }
+
+        /**
+         * @details First line predicted to be re-referenced in the distant future. The set is aged in
+         * one step by the distance of its oldest line to the maximum
+         */
+        int victim(unsigned set)
+        {
+            uint8_t* rrpv = &_rrpv[(size_t) set * _assoc];
+
+            unsigned way = 0;
+            for (unsigned i = 1; i < _assoc; i++)
+            {
+                if (rrpv[i] > rrpv[way]) {
+                    way = i;
+                }
+            }
+
+            uint8_t age = RRPV_MAX - rrpv[way];
+            if (age != 0)
+            {
+                for (unsigned i = 0; i < _assoc; i++) {
+                    rrpv[i] = rrpv[i] + age;
+                }
+            }
+            return way;
+        }
+
+        unsigned rank(unsigned set, unsigned way) const {
+            return _rrpv[(size_t) set * _assoc + way];
+        }
+
+        void save(ckpt_writer& out) const
+        {
+            out.put_vec(_rrpv);
+            out.put(_fills);
+        }
+
+        bool restore(ckpt_reader& in)
+        {
+            in.get_vec(_rrpv);
+            return in.get(_fills);
+        }
+};
+
+typedef rrip_policy<false> srrip_policy;
+typedef rrip_policy<true> brrip_policy;
+
+/**
+ * @details First in, first out. Every fill stamps its line with a running count, the victim of a
+ * full set is its line of the oldest stamp. Lines freed by coherence invalidations are filled out of
+ * turn, so insertion order is not a rotation of the ways
+ */
+class fifo_policy
+{
+    private:
+        unsigned _assoc;
+
+        // fill count of each line when it was filled, 0 for an invalid line
+        std::vector<uint64_t> _stamp;
+        uint64_t _fills;
+
+    public:
+
+        fifo_policy(unsigned num_sets, unsigned assoc) :
+            _assoc(assoc),
+            _stamp((size_t) num_sets * assoc, 0),
+            _fills(0)
+        {
+        }
+
+        void on_hit(unsigned, unsigned) {}
+
+        void on_fill(unsigned set, unsigned way) {
+            _stamp[(size_t) set * _assoc + way] = ++_fills;
+        }
+
+        void on_invalidate(unsigned set, unsigned way) {
+            _stamp[(size_t) set * _assoc + way] = 0;
+        }
+
+        /**
+         * @details Line of a full set filled first
+         */
+        int victim(unsigned set)
+        {
+            const uint64_t* stamp = &_stamp[(size_t) set * _assoc];
+            unsigned way = 0;
+            for (unsigned i = 1; i < _assoc; i++)
+            {
+                if (stamp[i] < stamp[way]) {
+                    way = i;
+                }
+            }
+            return way;
+        }
+
+        unsigned rank(unsigned set, unsigned way) const
+        {
+            // lines filled after this one
+            const uint64_t* stamp = &_stamp[(size_t) set * _assoc];
+            unsigned newer = 0;
+            for (unsigned i = 0; i < _assoc; i++) {
+                newer += stamp[i] > stamp[way];
+            }
+            return newer;
+        }
+
+        void save(ckpt_writer& out) const
+        {
+            out.put_vec(_stamp);
+            out.put(_fills);
+        }
+
+        bool restore(ckpt_reader& in)
+        {
+            in.get_vec(_stamp);
+            return in.get(_fills);
+        }
+};
+
+/**
+ * @details Uniformly random victims from a seeded xorshift generator, runs are reproducible
+ */
+class random_policy
+{
+    private:
+        unsigned _assoc;
+        uint64_t _state;
+
+    public:
+
+        random_policy(unsigned assoc, uint64_t seed) :
+            _assoc(assoc),
+            _state(seed != 0 ? seed : 1)
+        {
+        }
+
+        void on_hit(unsigned, unsigned) {}
+
+        void on_fill(unsigned, unsigned) {}
+
+        void on_invalidate(unsigned, unsigned) {}
+
+        int victim(unsigned)
+        {
+            _state ^= _state << 13;
+            _state ^= _state >> 7;
+            _state ^= _state << 17;
+            return _state % _assoc;
+        }
+
+        unsigned rank(unsigned, unsigned) const {
+            return 0;
+        }
+
+        void save(ckpt_writer& out) const {
+            out.put(_state);
+        }
+
+        bool restore(ckpt_reader& in) {
+            return in.get(_state);
+        }
+};
+
+/**
+ * @details One of the policies above. The cache dispatches on it once per batch, so the per
+ * request code is compiled for every policy without indirect calls
+ */
+typedef std::variant<lru_policy, plru_policy, srrip_policy, brrip_policy, fifo_policy, random_policy> repl_policy;
+
+/**
+ * @details Construct the state of a policy for num_sets sets of assoc ways
+ */
+inline repl_policy make_repl_policy(REPL_POLICY policy, unsigned num_sets, unsigned assoc, uint64_t seed)
+{
+    switch (policy)
+    {
+        case REPL_POLICY::PLRU: return plru_policy(num_sets, assoc);
+        case REPL_POLICY::SRRIP: return srrip_policy(num_sets, assoc);
+        case REPL_POLICY::BRRIP: return brrip_policy(num_sets, assoc);
+        case REPL_POLICY::FIFO: return fifo_policy(num_sets, assoc);
+        case REPL_POLICY::RANDOM: return random_policy(assoc, seed);
+        default: return lru_policy(num_sets, assoc);
+    }
+}
+
+/**
+ * @details Get a policy from its command line name, false if the name is unknown
+ */
+inline bool parse_repl_policy(const std::string& name, REPL_POLICY& policy)
+{
+    if (name == "lru") policy = REPL_POLICY::LRU;
+    else if (name == "plru") policy = REPL_POLICY::PLRU;
+    else if (name == "srrip") policy = REPL_POLICY::SRRIP;
+    else if (name == "brrip") policy = REPL_POLICY::BRRIP;
+    else if (name == "fifo") policy = REPL_POLICY::FIFO;
+    else if (name == "random") policy = REPL_POLICY::RANDOM;
+    else return false;
+    return true;
+}
+
+/**
+ * @details Name of a replacement policy as parse_repl_policy takes it
+ */
+inline const char* repl_policy_name(REPL_POLICY policy)
+{
+    switch (policy)
+    {
+        case REPL_POLICY::PLRU: return "plru";
+        case REPL_POLICY::SRRIP: return "srrip";
+        case REPL_POLICY::BRRIP: return "brrip";
+        case REPL_POLICY::FIFO: return "fifo";
+        case REPL_POLICY::RANDOM: return "random";
+        default: return "lru";
+    }
+}
+
+#endif // REPL_POLICY_H
@@ -0,0 +1,209 @@
+/**
+ * @file shard.cpp
+ * @details This file contains definitions of the set-sharded parallel simulation
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "shard.h"
+
+#include <work_pool.h>
+
+sharded_sim::sharded_sim(const sim_config& cfg, unsigned num_shards, size_t batch_size, const logger& log) :
+    base("Sharded simulation"),
+    _log(log),
+    _num_shards(num_shards > 0 ? num_shards : 1),
+    _mem_traffic(0)
+{
+    // origins are only tracked for batches
+    _batch_size = batch_size > 0 ? batch_size : 1024;
+
+    add_level("L1", cfg.l1_size, cfg.l1_assoc, cfg.l1_block_size, cfg);
+
+    // L2 blocks are 16 bytes, as in a single run
+    if (cfg.l2_size != 0) {
+        add_level("L2", cfg.l2_size, cfg.l2_assoc, 16, cfg);
+    }
+}
+
+bool sharded_sim::can_shard(const sim_config& cfg)
+{
+    // the victim cache is shared by all sets, random and bimodal RRIP draw from one stream for all sets
+    return cfg.vc_num_blocks == 0 && cfg.repl_policy != REPL_POLICY::RANDOM && cfg.repl_policy != REPL_POLICY::BRRIP;
+}
+
+void sharded_sim::add_level(const std::string& name, unsigned size, unsigned assoc, unsigned blocksize, const sim_config& cfg)
+{
+    level lvl;
+    for (unsigned t = 0; t < _num_shards; t++)
+    {
+        lvl.counters.emplace_back(new perf_counters::cache_counters());
+        lvl.shards.emplace_back(new cache(name, size, assoc, blocksize, 0, _log, lvl.counters.back().get(),
+            cfg.repl_policy, cfg.repl_seed));
+        lvl.counters.back()->attach_cache(lvl.shards.back().get());
+
+        lvl.sinks.emplace_back(new shard_sink(_log));
+        lvl.shards.back()->mk_next_connection(lvl.sinks.back().get());
+    }
+    _levels.push_back(std::move(lvl));
+}
+
+void sharded_sim::run(const std::vector<mem_req>& trace)
+{
+    std::vector<mem_req> in;
+    std::vector<mem_req> out;
+
+    for (size_t i = 0; i < _levels.size(); i++)
+    {
+        // the first level reads the trace, every other one the output of the level before
+        run_level(_levels[i], i == 0 ? trace : in, out);
+        in.swap(out);
+    }
+
+    // whatever leaves the last level goes to memory
+    _mem_traffic += in.size();
+}
+
+TRACE_STATUS sharded_sim::run(trace_reader& trace)
+{
+    std::vector<mem_req> chunk;
+    chunk.reserve(CHUNK_RECORDS);
+
+    TRACE_STATUS status = TRACE_STATUS::VALID;
+    while (status == TRACE_STATUS::VALID)
+    {
+        chunk.clear();
+        mem_req req;
+        while (chunk.size() < CHUNK_RECORDS && (status = trace.next(req)) == TRACE_STATUS::VALID) {
+            chunk.push_back(req);
+        }
+
+        if (!chunk.empty()) {
+            run(chunk);
+        }
+    }
+
+    return status;
+}
+
+void sharded_sim::run_level(level& lvl, const std::vector<mem_req>& in, std::vector<mem_req>& out)
+{
+    std::vector<shard_output> outputs(_num_shards);
+
+    work_pool pool(_num_shards);
+    pool.run(_num_shards, [&](size_t t)
+    {
+        cache& shard = *lvl.shards[t];
+        shard_sink& sink = *lvl.sinks[t];
+        shard_output& res = outputs[t];
+
+        // slice of sets owned by this shard
+        unsigned set_lo = 0;
+        while (set_lo < shard.get_num_sets() && shard.get_set_shard(set_lo, _num_shards) < t) {
+            set_lo++;
+        }
+        unsigned set_hi = set_lo;
+        while (set_hi < shard.get_num_sets() && shard.get_set_shard(set_hi, _num_shards) == t) {
+            set_hi++;
+        }
+
+        std::vector<mem_req> batch;
+        std::vector<uint64_t> batch_pos;
+        std::vector<uint32_t> origins;
+        batch.reserve(_batch_size);
+        batch_pos.reserve(_batch_size);
+
+        shard.set_origin_log(&origins);
+
+        auto flush = [&]()
+        {
+            if (batch.empty()) {
+                return;
+            }
+
+            origins.clear();
+            sink.reqs.clear();
+            shard.get_batch_frm_prev(batch.data(), batch.size());
+
+            // stamp everything sent on with the input position that caused it
+            for (size_t k = 0; k < sink.reqs.size(); k++)
+            {
+                res.reqs.push_back(sink.reqs[k]);
+                res.stamps.push_back(batch_pos[origins[k]]);
+            }
+
+            batch.clear();
+            batch_pos.clear();
+        };
+
+        for (uint64_t i = 0; i < in.size(); i++)
+        {
+            unsigned set = shard.get_set_num(in[i].addr);
+            if (set >= set_lo && set < set_hi)
+            {
+                batch.push_back(in[i]);
+                batch_pos.push_back(i);
+                if (batch.size() == _batch_size) {
+                    flush();
+                }
+            }
+        }
+        flush();
+
+        shard.set_origin_log(nullptr);
+    });
+
+    // k-way merge in input order, every input position belongs to exactly one shard
+    size_t total = 0;
+    for (auto& res : outputs) {
+        total += res.reqs.size();
+    }
+
+    out.clear();
+    out.reserve(total);
+
+    std::vector<size_t> head(_num_shards, 0);
+    for (size_t n = 0; n < total; n++)
+    {
+        unsigned next = _num_shards;
+        for (unsigned t = 0; t < _num_shards; t++)
+        {
+            if (head[t] < outputs[t].stamps.size() && (next == _num_shards || outputs[t].stamps[head[t]] < outputs[next].stamps[head[next]])) {
+                next = t;
+            }
+        }
+        out.push_back(outputs[next].reqs[head[next]]);
+        head[next]++;
+    }
+}
+
+void sharded_sim::print()
+{
+    for (auto& lvl : _levels)
+    {
+        std::vector<cache*> shards;
+        for (auto& shard : lvl.shards) {
+            shards.push_back(shard.get());
+        }
+        shards[0]->print(shards);
+    }
+}
+
+perf_counters::cache_counters sharded_sim::get_counters(unsigned level_idx) const
+{
+    perf_counters::cache_counters sum;
+    if (level_idx >= _levels.size()) {
+        return sum;
+    }
+
+    for (auto& counters : _levels[level_idx].counters)
+    {
+        sum.num_reads += counters->num_reads;
+        sum.read_misses += counters->read_misses;
+        sum.num_writes += counters->num_writes;
+        sum.write_misses += counters->write_misses;
+        sum.num_swap_req += counters->num_swap_req;
+        sum.num_swaps += counters->num_swaps;
+        sum.num_writebacks += counters->num_writebacks;
+    }
+    return sum;
+}
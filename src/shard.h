@@ -0,0 +1,132 @@
+/**
+ * @file shard.h
+ * @details This file contains the set-sharded parallel simulation of one configuration
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef SHARD_H
+#define SHARD_H
+
+// standard includes
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+// local includes
+#include <module.h>
+#include <cache.h>
+#include <perf_counters.h>
+#include <trace_reader.h>
+#include <sweep.h>
+
+/**
+ * @details Next level of a shard, keeps the requests it receives
+ */
+class shard_sink : public module
+{
+    public:
+        std::vector<mem_req> reqs;
+
+        shard_sink(const logger& log) : module("Shard sink", log) {}
+
+        void get_frm_prev()
+        {
+            if (req_ptr_prev != nullptr) {
+                reqs.push_back(*req_ptr_prev);
+            }
+        }
+
+        void get_batch_frm_prev(mem_req* batch, size_t num) {
+            reqs.insert(reqs.end(), batch, batch + num);
+        }
+};
+
+/**
+ * @details Simulates one hierarchy with the sets of every level split over threads. Without a victim
+ * cache the sets of a cache never interact, so each thread runs its own copy of a level on the
+ * requests mapping to its slice of sets. The requests a level sends on are tagged with the position
+ * of the request causing them and merged back into trace order, which makes the stream reaching the
+ * next level, and so every counter, identical to a sequential run. A trace is run a chunk at a time,
+ * every level keeping its state from chunk to chunk, so it is never held in memory whole
+ */
+class sharded_sim : public base
+{
+    private:
+        // one level of the hierarchy
+        struct level
+        {
+            std::vector<std::unique_ptr<cache>> shards;
+            std::vector<std::unique_ptr<perf_counters::cache_counters>> counters;
+            std::vector<std::unique_ptr<shard_sink>> sinks;
+        };
+
+        // requests a shard sent on, with the position in the level input that caused each
+        struct shard_output
+        {
+            std::vector<mem_req> reqs;
+            std::vector<uint64_t> stamps;
+        };
+
+        // records of a trace decoded and run at a time
+        static const size_t CHUNK_RECORDS = 1 << 20;
+
+        logger _log;
+        unsigned _num_shards;
+        size_t _batch_size;
+
+        std::vector<level> _levels;
+        uint64_t _mem_traffic;
+
+        /**
+         * @details Add a level of num_shards identical caches
+         */
+        void add_level(const std::string& name, unsigned size, unsigned assoc, unsigned blocksize, const sim_config& cfg);
+
+        /**
+         * @details Run the requests of in through a level, returning the requests for the next level in order
+         */
+        void run_level(level& lvl, const std::vector<mem_req>& in, std::vector<mem_req>& out);
+
+    public:
+
+        /**
+         * @details Build the hierarchy of cfg, which must not have a victim cache
+         */
+        sharded_sim(const sim_config& cfg, unsigned num_shards, size_t batch_size, const logger& log);
+
+        /**
+         * @details Check if cfg can be sharded: no victim cache and a replacement policy without state
+         * shared between sets
+         */
+        static bool can_shard(const sim_config& cfg);
+
+        /**
+         * @details Simulate the next records of an already decoded trace, from where the last call stopped
+         */
+        void run(const std::vector<mem_req>& trace);
+
+        /**
+         * @details Simulate the rest of trace, decoding it a chunk at a time. Returns END_OF_TRACE once the
+         * whole trace was run, the failing status otherwise, with the records before the failing one run
+         */
+        TRACE_STATUS run(trace_reader& trace);
+
+        /**
+         * @details Print the contents of every level
+         */
+        void print();
+
+        /**
+         * @details Counters of a level, summed over its shards
+         */
+        perf_counters::cache_counters get_counters(unsigned level_idx) const;
+
+        /**
+         * @details Number of requests reaching main memory
+         */
+        uint64_t get_mem_traffic() const {
+            return _mem_traffic;
+        }
+};
+
+#endif // SHARD_H
@@ -0,0 +1,153 @@
+/**
+ * @file spsc_ring.h
+ * @details This file contains a bounded lock-free single-producer/single-consumer ring
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+// standard includes
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <thread>
+
+/**
+ * @details Lock-free ring of preallocated slots shared by exactly one producer and one consumer thread.
+ * Slots are filled and drained in place, so slot types owning buffers are never reallocated.
+ */
+template <typename T>
+class spsc_ring
+{
+    private:
+        std::vector<T> _slots;
+        size_t _mask;
+
+        // producer and consumer indices live on their own cache lines
+        alignas(64) std::atomic<size_t> _head;
+        alignas(64) std::atomic<size_t> _tail;
+
+        // stall statistics, each only written by its own side
+        alignas(64) unsigned long _producer_stalls;
+        alignas(64) unsigned long _consumer_stalls;
+
+    public:
+
+        /**
+         * @details Construct a ring with capacity rounded up to a power of two
+         */
+        spsc_ring(size_t capacity, const T& init = T()) : _head(0), _tail(0)
+        {
+            size_t size = 1;
+            while (size < capacity) {
+                size = size << 1;
+            }
+            _slots.assign(size, init);
+            _mask = size - 1;
+
+            _producer_stalls = 0;
+            _consumer_stalls = 0;
+        }
+
+        // setup, only while neither side is running
+
+        size_t capacity() const {
+            return _slots.size();
+        }
+
+        /**
+         * @details Slot i of the ring, to prepare its contents
+         */
+        T& slot(size_t i) {
+            return _slots[i];
+        }
+
+        // producer side
+
+        /**
+         * @details Get the next free slot, nullptr if the ring is full
+         */
+        T* try_produce()
+        {
+            size_t head = _head.load(std::memory_order_relaxed);
+            if (head - _tail.load(std::memory_order_acquire) == _slots.size()) {
+                return nullptr;
+            }
+            return &_slots[head & _mask];
+        }
+
+        /**
+         * @details Get the next free slot, waiting while the ring is full
+         */
+        T* produce()
+        {
+            T* slot = try_produce();
+            if (slot == nullptr)
+            {
+                _producer_stalls++;
+                while ((slot = try_produce()) == nullptr) {
+                    std::this_thread::yield();
+                }
+            }
+            return slot;
+        }
+
+        /**
+         * @details Publish the slot handed out by produce()
+         */
+        void commit()
+        {
+            _head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // consumer side
+
+        /**
+         * @details Get the oldest filled slot, nullptr if the ring is empty
+         */
+        T* try_consume()
+        {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            if (tail == _head.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return &_slots[tail & _mask];
+        }
+
+        /**
+         * @details Get the oldest filled slot, waiting while the ring is empty
+         */
+        T* consume()
+        {
+            T* slot = try_consume();
+            if (slot == nullptr)
+            {
+                _consumer_stalls++;
+                while ((slot = try_consume()) == nullptr) {
+                    std::this_thread::yield();
+                }
+            }
+            return slot;
+        }
+
+        /**
+         * @details Hand the slot returned by consume() back to the producer
+         */
+        void release()
+        {
+            _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        // statistics, only meaningful once both sides are done
+
+        unsigned long get_producer_stalls() const {
+            return _producer_stalls;
+        }
+
+        unsigned long get_consumer_stalls() const {
+            return _consumer_stalls;
+        }
+};
+
+#endif // SPSC_RING_H
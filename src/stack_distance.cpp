@@ -0,0 +1,157 @@
+/**
+ * @file stack_distance.cpp
+ * @details This file contains definitions of the single pass LRU stack distance engine
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "stack_distance.h"
+
+#include <algorithm>
+
+// lru_stack
+
+lru_stack::lru_stack() : _clock(0), _live(0)
+{
+    // slots are allocated on first use, most sets of large set counts stay small
+}
+
+void lru_stack::add(uint32_t slot, int delta)
+{
+    for (size_t i = slot + 1; i < _tree.size(); i += i & (~i + 1)) {
+        _tree[i] += delta;
+    }
+}
+
+uint32_t lru_stack::prefix(uint32_t slot) const
+{
+    uint32_t sum = 0;
+    for (size_t i = slot + 1; i > 0; i -= i & (~i + 1)) {
+        sum += _tree[i];
+    }
+    return sum;
+}
+
+void lru_stack::compact(std::vector<uint32_t>& slot_of)
+{
+    size_t capacity = std::max<size_t>(16, 2 * (size_t) _live);
+
+    // keep marked slots in time order
+    std::vector<uint32_t> owner(capacity, NONE);
+    uint32_t num = 0;
+    for (uint32_t slot = 0; slot < _clock; slot++)
+    {
+        if (_owner[slot] != NONE)
+        {
+            owner[num] = _owner[slot];
+            slot_of[owner[num]] = num + 1;
+            num++;
+        }
+    }
+    _owner.swap(owner);
+    _clock = num;
+
+    // linear time Fenwick build
+    _tree.assign(capacity + 1, 0);
+    for (size_t i = 1; i <= capacity; i++)
+    {
+        _tree[i] += (i <= num);
+        size_t parent = i + (i & (~i + 1));
+        if (parent <= capacity) {
+            _tree[parent] += _tree[i];
+        }
+    }
+}
+
+uint32_t lru_stack::touch(uint32_t id, std::vector<uint32_t>& slot_of)
+{
+    uint32_t distance = COLD;
+
+    // already on top, the stack stays as it is
+    if (slot_of[id] == _clock && _clock != 0) {
+        return 0;
+    }
+
+    // take the block off its previous slot
+    if (slot_of[id] != 0)
+    {
+        uint32_t slot = slot_of[id] - 1;
+        distance = _live - prefix(slot);
+
+        add(slot, -1);
+        _owner[slot] = NONE;
+        _live--;
+    }
+
+    if (_clock == _owner.size()) {
+        compact(slot_of);
+    }
+
+    // and put it on top
+    uint32_t slot = _clock++;
+    add(slot, 1);
+    _owner[slot] = id;
+    slot_of[id] = slot + 1;
+    _live++;
+
+    return distance;
+}
+
+// stack_distance
+
+stack_distance::stack_distance(unsigned block_bits, uint64_t max_size) :
+    base("Stack distance"),
+    _block_bits(block_bits)
+{
+    for (unsigned set_bits = 0; (1ull << (block_bits + set_bits)) <= max_size; set_bits++)
+    {
+        level lvl;
+        lvl.max_ways = max_size >> (block_bits + set_bits);
+        lvl.sets.resize(1ull << set_bits);
+        lvl.hist[OP_TYPE::LOAD].assign(lvl.max_ways + 1, 0);
+        lvl.hist[OP_TYPE::STORE].assign(lvl.max_ways + 1, 0);
+        _levels.push_back(std::move(lvl));
+    }
+
+    _accesses[OP_TYPE::LOAD] = 0;
+    _accesses[OP_TYPE::STORE] = 0;
+}
+
+void stack_distance::access(const mem_req& req)
+{
+    unsigned block = req.addr >> _block_bits;
+
+    // dense id of the block, new blocks get a slot entry on every level
+    auto ins = _block_ids.emplace(block, _block_ids.size());
+    uint32_t id = ins.first->second;
+    if (ins.second)
+    {
+        for (auto& lvl : _levels) {
+            lvl.slot_of.push_back(0);
+        }
+    }
+
+    _accesses[req.req_op_type]++;
+
+    for (size_t set_bits = 0; set_bits < _levels.size(); set_bits++)
+    {
+        level& lvl = _levels[set_bits];
+        unsigned set = block & ((1u << set_bits) - 1);
+
+        uint32_t distance = lvl.sets[set].touch(id, lvl.slot_of);
+
+        // cold and deeper accesses share the last bin
+        lvl.hist[req.req_op_type][std::min<uint32_t>(distance, lvl.max_ways)]++;
+    }
+}
+
+uint64_t stack_distance::get_misses(unsigned set_bits, unsigned assoc, OP_TYPE op) const
+{
+    // a request misses in assoc ways when assoc or more other blocks of its set were used since
+    const std::vector<uint64_t>& hist = _levels[set_bits].hist[op];
+
+    uint64_t misses = 0;
+    for (size_t distance = assoc; distance < hist.size(); distance++) {
+        misses += hist[distance];
+    }
+    return misses;
+}
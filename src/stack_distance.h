@@ -0,0 +1,140 @@
+/**
+ * @file stack_distance.h
+ * @details This file contains the class declarations of the single pass LRU stack distance engine
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef STACK_DISTANCE_H
+#define STACK_DISTANCE_H
+
+// standard includes
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// local includes
+#include <base.h>
+#include <message.h>
+
+/**
+ * @details LRU stack of one set. Every access stamps its block with the next slot of a time line
+ * and a Fenwick tree over the slots marks the ones still holding the latest access of their block,
+ * so the stack distance of a block is the number of marks after its previous slot. Slots are
+ * renumbered once the time line is used up, which bounds memory by the number of distinct blocks
+ */
+class lru_stack
+{
+    public:
+        // distance returned for the first access to a block
+        static const uint32_t COLD = ~0u;
+
+    private:
+        // Fenwick tree over the slots, 1-based
+        std::vector<uint32_t> _tree;
+
+        // block id owning each marked slot, NONE when unmarked
+        std::vector<uint32_t> _owner;
+
+        uint32_t _clock;
+        uint32_t _live;
+
+        static const uint32_t NONE = ~0u;
+
+        void add(uint32_t slot, int delta);
+        uint32_t prefix(uint32_t slot) const;
+
+        /**
+         * @details Renumber marked slots from 0 and resize the time line. slot_of is the slot table of
+         * the engine, indexed by block id
+         */
+        void compact(std::vector<uint32_t>& slot_of);
+
+    public:
+
+        lru_stack();
+
+        /**
+         * @details Move block id to the top of the stack and get its distance from the top before the
+         * move, COLD if it was not on the stack. slot_of holds the current slot of every block of
+         * this set plus one, 0 when not on the stack
+         */
+        uint32_t touch(uint32_t id, std::vector<uint32_t>& slot_of);
+
+        /**
+         * @details Number of distinct blocks on the stack
+         */
+        uint32_t get_depth() const {
+            return _live;
+        }
+};
+
+/**
+ * @details Mattson stack distance analysis of one trace for a fixed block size. One LRU stack per
+ * set is kept for every power of two set count at once, and a histogram of distances per set count
+ * gives the misses of every LRU cache of that set count in a single pass, for any associativity
+ */
+class stack_distance : public base
+{
+    private:
+        unsigned _block_bits;
+
+        // per set count state, level k has 2^k sets
+        struct level
+        {
+            unsigned max_ways;
+            std::vector<lru_stack> sets;
+
+            // slot plus one of every block id in its set
+            std::vector<uint32_t> slot_of;
+
+            // distance histograms per op type, the last bin holds deeper and cold accesses
+            std::vector<uint64_t> hist[2];
+        };
+
+        std::vector<level> _levels;
+
+        // dense ids of block addresses
+        std::unordered_map<unsigned, uint32_t> _block_ids;
+
+        uint64_t _accesses[2];
+
+    public:
+
+        /**
+         * @details Analyze caches with blocks of 2^block_bits bytes of up to max_size bytes
+         */
+        stack_distance(unsigned block_bits, uint64_t max_size);
+
+        /**
+         * @details Account one request
+         */
+        void access(const mem_req& req);
+
+        /**
+         * @details Number of set counts analyzed, set counts are 2^0 to 2^(get_num_levels() - 1)
+         */
+        unsigned get_num_levels() const {
+            return _levels.size();
+        }
+
+        /**
+         * @details Largest associativity analyzed for 2^set_bits sets
+         */
+        unsigned get_max_ways(unsigned set_bits) const {
+            return _levels[set_bits].max_ways;
+        }
+
+        /**
+         * @details Number of requests of type op
+         */
+        uint64_t get_accesses(OP_TYPE op) const {
+            return _accesses[op];
+        }
+
+        /**
+         * @details Misses of type op of an LRU cache of 2^set_bits sets and assoc ways
+         */
+        uint64_t get_misses(unsigned set_bits, unsigned assoc, OP_TYPE op) const;
+};
+
+#endif // STACK_DISTANCE_H
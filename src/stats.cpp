@@ -0,0 +1,351 @@
+/**
+ * @file stats.cpp
+ * @details This file contains definitions of the performance analysis and the stats export
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "stats.h"
+
+#include <cmath>
+#include <cstdio>
+
+#include <cacti_store.h>
+
+bool get_sim_figures(cacti_store& cacti, const sim_config& cfg, sim_figures& figs, std::string& failed_level)
+{
+    figs = sim_figures();
+
+    if (cacti.get(cfg.l1_size, cfg.l1_block_size, cfg.l1_assoc, &figs.l1.access_time, &figs.l1.energy, &figs.l1.area) != 0)
+    {
+        failed_level = "L1";
+        return false;
+    }
+
+    if (cfg.vc_num_blocks != 0)
+    {
+        if (cacti.get(cfg.vc_num_blocks * cfg.l1_block_size, cfg.vc_num_blocks, cfg.vc_num_blocks,
+                      &figs.vc.access_time, &figs.vc.energy, &figs.vc.area) != 0) {
+            figs.vc.access_time = 0.2f;
+        }
+    }
+
+    // L2 blocks are 16 bytes
+    if (cfg.l2_size != 0 &&
+        cacti.get(cfg.l2_size, 16, cfg.l2_assoc, &figs.l2.access_time, &figs.l2.energy, &figs.l2.area) != 0)
+    {
+        failed_level = "L2";
+        return false;
+    }
+
+    return true;
+}
+
+sim_metrics compute_metrics(const sim_config& cfg, const sim_result& res, const sim_figures& figs)
+{
+    const perf_counters::cache_counters& l1 = res.l1;
+    const perf_counters::cache_counters& l2 = res.l2;
+
+    sim_metrics m;
+    m.swap_request_rate = 0.0f;
+    m.l2_miss_rate = 0.0f;
+
+    m.l1_vc_miss_rate = (l1.read_misses + l1.write_misses - l1.num_swaps) / (float)(l1.num_reads + l1.num_writes);
+
+    if (cfg.l2_size != 0) {
+        m.l2_miss_rate = l2.read_misses / (float) l2.num_reads;
+    }
+
+    // compute swap rate
+    if (cfg.vc_num_blocks != 0) {
+        m.swap_request_rate = l1.num_swap_req / (float) (l1.num_reads + l1.num_writes);
+    }
+
+    double mem_energy = 0.05f;
+    double mem_miss_penalty = 20.0f + cfg.l1_block_size / 16.0f;
+    double l1_miss_penalty = 0.0f;
+    double l1_miss_penalty_num = 0.0f;
+
+    // get l1 miss penalty
+    if (cfg.l2_size == 0) {
+        l1_miss_penalty = mem_miss_penalty;
+    } else {
+        l1_miss_penalty = figs.l2.access_time + m.l2_miss_rate * static_cast<double>(mem_miss_penalty);
+    }
+
+    // get total area
+    m.total_area = figs.l1.area + figs.l2.area + figs.vc.area;
+
+    // average acceess time
+    m.average_access_time = figs.l1.access_time + m.l1_vc_miss_rate * l1_miss_penalty + m.swap_request_rate * figs.vc.access_time;
+
+    // total access time
+    if (cfg.l2_size == 0) {
+        l1_miss_penalty_num = (l1.read_misses + l1.write_misses) * mem_miss_penalty;
+    } else {
+        l1_miss_penalty_num = static_cast<double>(figs.l2.access_time) * (l2.num_reads + l2.num_writes) + (l2.read_misses + l2.write_misses) * mem_miss_penalty;
+    }
+    double total_acc_time = static_cast<double>(figs.l1.access_time) * (l1.num_reads + l1.num_writes) + \
+                            static_cast<double>(l1_miss_penalty_num) + \
+                            (l1.num_swaps) * static_cast<double>(figs.vc.access_time);
+
+    // energy delay product
+    double e_delay_prod = (l1.num_reads + l1.num_writes + l1.read_misses + l1.write_misses) * static_cast<double>(figs.l1.energy);
+    if (cfg.vc_num_blocks != 0)
+        e_delay_prod += (2*l1.num_swaps) * static_cast<double>(figs.vc.energy);
+    if (cfg.l2_size != 0) {
+        e_delay_prod += (l2.read_misses + l2.write_misses + l2.num_reads + l2.num_writes) * static_cast<double>(figs.l2.energy);
+        e_delay_prod += (l2.read_misses + l2.write_misses + l2.num_writebacks) * static_cast<double>(mem_energy);
+    } else {
+        e_delay_prod += (l1.read_misses + l1.write_misses - l1.num_swaps + l1.num_writebacks) * static_cast<double>(mem_energy);
+    }
+    m.energy_delay_product = e_delay_prod * total_acc_time;
+
+    return m;
+}
+
+/**
+ * @details Write a number, enough digits to read back the same value. JSON and CSV have no
+ * infinities or NaN, those are written as null_text
+ */
+static void put_number(FILE* file, double val, int digits, const char* null_text)
+{
+    if (std::isfinite(val)) {
+        fprintf(file, "%.*g", digits, val);
+    }
+    else {
+        fputs(null_text, file);
+    }
+}
+
+static void put_number(FILE* file, float val, const char* null_text)
+{
+    put_number(file, val, 9, null_text);
+}
+
+static void put_number(FILE* file, double val, const char* null_text)
+{
+    put_number(file, val, 17, null_text);
+}
+
+/**
+ * @details Misses over accesses of a level
+ */
+static double miss_rate(const perf_counters::cache_counters& c)
+{
+    return (c.read_misses + c.write_misses) / (double) (c.num_reads + c.num_writes);
+}
+
+static void put_json_array(FILE* file, const std::vector<perf_counters::set_counters>& sets, uint64_t perf_counters::set_counters::* field)
+{
+    fputc('[', file);
+    for (size_t i = 0; i < sets.size(); i++) {
+        fprintf(file, i == 0 ? "%lu" : ", %lu", sets[i].*field);
+    }
+    fputc(']', file);
+}
+
+static void put_json_level(FILE* file, const char* name, const perf_counters::cache_counters& c)
+{
+    fprintf(file, "        {\"name\": \"%s\", \"reads\": %lu, \"read_misses\": %lu, \"writes\": %lu, \"write_misses\": %lu, "
+                  "\"swap_requests\": %lu, \"swaps\": %lu, \"writebacks\": %lu, \"miss_rate\": ",
+            name, c.num_reads, c.read_misses, c.num_writes, c.write_misses, c.num_swap_req, c.num_swaps, c.num_writebacks);
+    put_number(file, miss_rate(c), "null");
+
+    if (c.is_classified)
+    {
+        fprintf(file, ", \"compulsory_misses\": %lu, \"capacity_misses\": %lu, \"conflict_misses\": %lu",
+                c.compulsory_misses, c.capacity_misses, c.conflict_misses);
+    }
+
+    if (!c.sets.empty())
+    {
+        fputs(",\n         \"sets\": {\"hits\": ", file);
+        put_json_array(file, c.sets, &perf_counters::set_counters::hits);
+        fputs(", \"misses\": ", file);
+        put_json_array(file, c.sets, &perf_counters::set_counters::misses);
+        fputs(", \"writebacks\": ", file);
+        put_json_array(file, c.sets, &perf_counters::set_counters::writebacks);
+        if (c.is_classified)
+        {
+            fputs(", \"compulsory\": ", file);
+            put_json_array(file, c.sets, &perf_counters::set_counters::compulsory);
+            fputs(", \"capacity\": ", file);
+            put_json_array(file, c.sets, &perf_counters::set_counters::capacity);
+            fputs(", \"conflict\": ", file);
+            put_json_array(file, c.sets, &perf_counters::set_counters::conflict);
+        }
+        fputc('}', file);
+    }
+
+    fputc('}', file);
+}
+
+bool write_stats_json(const std::string& path, const std::vector<stats_run>& runs)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    fputs("{\"runs\": [", file);
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        const stats_run& run = runs[i];
+        const sim_config& cfg = run.cfg;
+
+        fputs(i == 0 ? "\n" : ",\n", file);
+        fprintf(file, "    {\"config\": {\"l1_size\": %u, \"l1_assoc\": %u, \"l1_block\": %u, \"vc_blocks\": %u, "
+                      "\"l2_size\": %u, \"l2_assoc\": %u, \"repl\": \"%s\", \"seed\": %lu},\n",
+                cfg.l1_size, cfg.l1_assoc, cfg.l1_block_size, cfg.vc_num_blocks, cfg.l2_size, cfg.l2_assoc,
+                repl_policy_name(cfg.repl_policy), cfg.repl_seed);
+
+        fputs("     \"levels\": [\n", file);
+        put_json_level(file, "L1", run.res.l1);
+        if (cfg.l2_size != 0)
+        {
+            fputs(",\n", file);
+            put_json_level(file, "L2", run.res.l2);
+        }
+        fprintf(file, "],\n     \"mem_traffic\": %lu,\n     \"metrics\": ", run.res.mem_traffic);
+
+        if (run.has_metrics)
+        {
+            const sim_metrics& m = run.metrics;
+            fputs("{\"l1_vc_miss_rate\": ", file);
+            put_number(file, m.l1_vc_miss_rate, "null");
+            fputs(", \"l2_miss_rate\": ", file);
+            put_number(file, m.l2_miss_rate, "null");
+            fputs(", \"swap_request_rate\": ", file);
+            put_number(file, m.swap_request_rate, "null");
+            fputs(", \"average_access_time\": ", file);
+            put_number(file, m.average_access_time, "null");
+            fputs(", \"energy_delay_product\": ", file);
+            put_number(file, m.energy_delay_product, "null");
+            fputs(", \"total_area\": ", file);
+            put_number(file, m.total_area, "null");
+            fputs("}}", file);
+        }
+        else {
+            fputs("null}", file);
+        }
+    }
+    fputs("\n]}\n", file);
+
+    return fclose(file) == 0;
+}
+
+bool write_stats_csv(const std::string& path, const std::vector<stats_run>& runs)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    fputs("l1_size,l1_assoc,l1_block,vc_blocks,l2_size,l2_assoc,"
+          "l1_reads,l1_read_misses,l1_writes,l1_write_misses,swap_requests,swaps,l1_vc_writebacks,"
+          "l2_reads,l2_read_misses,l2_writes,l2_write_misses,l2_writebacks,mem_traffic,"
+          "repl,seed,l1_vc_miss_rate,l2_miss_rate,swap_request_rate,average_access_time,energy_delay_product,total_area,"
+          "l1_compulsory_misses,l1_capacity_misses,l1_conflict_misses,l2_compulsory_misses,l2_capacity_misses,l2_conflict_misses\n", file);
+
+    for (const stats_run& run : runs)
+    {
+        const sim_config& cfg = run.cfg;
+        const perf_counters::cache_counters& l1 = run.res.l1;
+        const perf_counters::cache_counters& l2 = run.res.l2;
+
+        fprintf(file, "%u,%u,%u,%u,%u,%u,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%lu,%s,%lu",
+                cfg.l1_size, cfg.l1_assoc, cfg.l1_block_size, cfg.vc_num_blocks, cfg.l2_size, cfg.l2_assoc,
+                l1.num_reads, l1.read_misses, l1.num_writes, l1.write_misses, l1.num_swap_req, l1.num_swaps, l1.num_writebacks,
+                l2.num_reads, l2.read_misses, l2.num_writes, l2.write_misses, l2.num_writebacks, run.res.mem_traffic,
+                repl_policy_name(cfg.repl_policy), cfg.repl_seed);
+
+        if (run.has_metrics)
+        {
+            const sim_metrics& m = run.metrics;
+            fputc(',', file);
+            put_number(file, m.l1_vc_miss_rate, "");
+            fputc(',', file);
+            put_number(file, m.l2_miss_rate, "");
+            fputc(',', file);
+            put_number(file, m.swap_request_rate, "");
+            fputc(',', file);
+            put_number(file, m.average_access_time, "");
+            fputc(',', file);
+            put_number(file, m.energy_delay_product, "");
+            fputc(',', file);
+            put_number(file, m.total_area, "");
+        }
+        else {
+            fputs(",,,,,,", file);
+        }
+
+        for (const perf_counters::cache_counters* c : {&l1, &l2})
+        {
+            if (c->is_classified) {
+                fprintf(file, ",%lu,%lu,%lu", c->compulsory_misses, c->capacity_misses, c->conflict_misses);
+            }
+            else {
+                fputs(",,,", file);
+            }
+        }
+        fputc('\n', file);
+    }
+
+    return fclose(file) == 0;
+}
+
+bool write_set_stats_csv(const std::string& path, const stats_run& run)
+{
+    FILE* file = fopen(path.c_str(), "w");
+    if (file == nullptr) {
+        return false;
+    }
+
+    fputs("level,set,hits,misses,writebacks,compulsory,capacity,conflict\n", file);
+
+    const char* names[] = {"L1", "L2"};
+    const perf_counters::cache_counters* levels[] = {&run.res.l1, &run.res.l2};
+    for (unsigned lvl = 0; lvl < 2; lvl++)
+    {
+        const std::vector<perf_counters::set_counters>& sets = levels[lvl]->sets;
+        for (size_t set = 0; set < sets.size(); set++)
+        {
+            fprintf(file, "%s,%zu,%lu,%lu,%lu", names[lvl], set, sets[set].hits, sets[set].misses, sets[set].writebacks);
+            if (levels[lvl]->is_classified) {
+                fprintf(file, ",%lu,%lu,%lu\n", sets[set].compulsory, sets[set].capacity, sets[set].conflict);
+            }
+            else {
+                fputs(",,,\n", file);
+            }
+        }
+    }
+
+    return fclose(file) == 0;
+}
+
+bool export_stats(const stats_paths& paths, const std::vector<stats_run>& runs, logger& log)
+{
+    base stats_base("Stats export");
+    bool is_ok = true;
+
+    if (!paths.json.empty() && !write_stats_json(paths.json, runs))
+    {
+        log.log(&stats_base, verbose::FATAL, paths.json + ": Unable to write stats");
+        is_ok = false;
+    }
+
+    if (!paths.csv.empty() && !write_stats_csv(paths.csv, runs))
+    {
+        log.log(&stats_base, verbose::FATAL, paths.csv + ": Unable to write stats");
+        is_ok = false;
+    }
+
+    // per set counters are only kept for a single run
+    if (!paths.sets.empty() && runs.size() == 1 && !write_set_stats_csv(paths.sets, runs[0]))
+    {
+        log.log(&stats_base, verbose::FATAL, paths.sets + ": Unable to write per set stats");
+        is_ok = false;
+    }
+
+    return is_ok;
+}
@@ -0,0 +1,130 @@
+/**
+ * @file stats.h
+ * @details This file contains the performance analysis of a run and its export as JSON and CSV
+ *
+ * A JSON export is one object holding a "runs" array, with for every run its configuration, the
+ * counters and miss rate of every level, memory traffic and the derived metrics:
+ *
+ *      {"runs": [{"config": {...}, "levels": [{"name": "L1", ...}, ...], "mem_traffic": N, "metrics": {...}}]}
+ *
+ * Per set counters, when on, are added to their level as "sets": {"hits": [...], "misses": [...],
+ * "writebacks": [...]}. A CSV export has a header line and one line per run, with the columns of a
+ * sweep followed by the configuration's policy and seed, the derived metrics and the 3C breakdown of
+ * both levels. Metrics that could not be computed and misses that were not classified are left out of
+ * JSON levels, null in JSON metrics and empty in CSV.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+// standard includes
+#include <string>
+#include <vector>
+
+// local includes
+#include <sweep.h>
+
+class cacti_store;
+
+/**
+ * @details CACTI figures of one organisation, as the performance analysis takes them
+ */
+struct cacti_figures
+{
+    float access_time;
+    float energy;
+    float area;
+
+    cacti_figures() : access_time(0.0f), energy(0.0f), area(0.0f) {}
+};
+
+/**
+ * @details CACTI figures of the levels of a configuration, zero for levels it does not have
+ */
+struct sim_figures
+{
+    cacti_figures l1;
+    cacti_figures vc;
+    cacti_figures l2;
+};
+
+/**
+ * @details Figures derived from the counters of a run and the CACTI figures of its levels
+ */
+struct sim_metrics
+{
+    float l1_vc_miss_rate;
+    float l2_miss_rate;
+    float swap_request_rate;
+
+    double average_access_time;
+    double energy_delay_product;
+    double total_area;
+};
+
+/**
+ * @details Get the CACTI figures of every level of cfg. A victim cache CACTI fails on is given an
+ * access time of 0.2. False if CACTI fails on L1 or L2, failed_level then names it
+ */
+bool get_sim_figures(cacti_store& cacti, const sim_config& cfg, sim_figures& figs, std::string& failed_level);
+
+/**
+ * @details Miss rates, average access time, energy-delay product and area of a run
+ */
+sim_metrics compute_metrics(const sim_config& cfg, const sim_result& res, const sim_figures& figs);
+
+/**
+ * @details Everything exported about one run
+ */
+struct stats_run
+{
+    sim_config cfg;
+    sim_result res;
+
+    bool has_metrics;
+    sim_metrics metrics;
+
+    stats_run() : has_metrics(false), metrics() {}
+};
+
+/**
+ * @details Files runs are exported to, none when empty
+ */
+struct stats_paths
+{
+    std::string json;
+    std::string csv;
+
+    // per set counters, one CSV line per set of every level
+    std::string sets;
+
+    bool is_any() const {
+        return !json.empty() || !csv.empty() || !sets.empty();
+    }
+};
+
+/**
+ * @details Write runs as JSON to path, false if it could not be written
+ */
+bool write_stats_json(const std::string& path, const std::vector<stats_run>& runs);
+
+/**
+ * @details Write runs as CSV to path, false if it could not be written
+ */
+bool write_stats_csv(const std::string& path, const std::vector<stats_run>& runs);
+
+/**
+ * @details Write the per set counters of every level of a run to path as lines of
+ * "level,set,hits,misses,writebacks,compulsory,capacity,conflict", the last three empty when misses
+ * are not classified. False if it could not be written
+ */
+bool write_set_stats_csv(const std::string& path, const stats_run& run);
+
+/**
+ * @details Write runs to every file of paths, logging the ones that could not be written. False if any
+ * could not be
+ */
+bool export_stats(const stats_paths& paths, const std::vector<stats_run>& runs, logger& log);
+
+#endif // STATS_H
@@ -0,0 +1,285 @@
+/**
+ * @file sweep.cpp
+ * @details This file contains definitions of the design space sweep driver
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "sweep.h"
+
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <memory>
+
+#include <cpu.h>
+#include <cache.h>
+#include <main_memory.h>
+#include <trace_reader.h>
+#include <work_pool.h>
+#include <cacti_store.h>
+#include <stats.h>
+
+bool sim_config::is_valid() const
+{
+    if (l1_block_size == 0 || l1_assoc == 0 || l1_size < l1_block_size * l1_assoc || l1_size % (l1_block_size * l1_assoc) != 0) {
+        return false;
+    }
+
+    // L2 blocks are 16 bytes, as in a single run
+    if (l2_size != 0 && (l2_assoc == 0 || l2_size < 16 * l2_assoc || l2_size % (16 * l2_assoc) != 0)) {
+        return false;
+    }
+
+    return true;
+}
+
+sim_result simulate(const sim_config& cfg, const std::vector<mem_req>& trace, size_t batch_size)
+{
+    // only fatal errors are worth printing from inside a sweep
+    logger log(verbose::FATAL);
+
+    sim_result res;
+
+    cpu core(trace, log);
+    core.set_batch_size(batch_size);
+
+    cache l1_cache("L1", cfg.l1_size, cfg.l1_assoc, cfg.l1_block_size, cfg.vc_num_blocks, log, &res.l1,
+        cfg.repl_policy, cfg.repl_seed);
+    res.l1.attach_cache(&l1_cache);
+
+    main_memory main_mem(log);
+
+    core.mk_next_connection(&l1_cache);
+
+    std::unique_ptr<cache> l2_cache;
+    if (cfg.l2_size != 0)
+    {
+        l2_cache.reset(new cache("L2", cfg.l2_size, cfg.l2_assoc, 16, 0, log, &res.l2, cfg.repl_policy, cfg.repl_seed));
+        res.l2.attach_cache(l2_cache.get());
+
+        l1_cache.mk_next_connection(l2_cache.get());
+        l2_cache->mk_next_connection(&main_mem);
+    }
+    else {
+        l1_cache.mk_next_connection(&main_mem);
+    }
+
+    core.sequencer();
+
+    // caches are gone once this returns
+    res.l1.attach_cache(nullptr);
+    res.l2.attach_cache(nullptr);
+    res.mem_traffic = main_mem.mem_access;
+
+    return res;
+}
+
+bool read_sweep_grid(const std::string& path, const sim_config& base_cfg, std::vector<sim_config>& configs, logger& log)
+{
+    base grid_base("Sweep grid");
+
+    std::ifstream file(path);
+    if (!file.is_open())
+    {
+        log.log(&grid_base, verbose::FATAL, path + ": Unable to find file");
+        return false;
+    }
+
+    // values of every parameter, in sim_config order
+    const char* names[] = {"l1_size", "l1_assoc", "l1_block", "vc_blocks", "l2_size", "l2_assoc"};
+    unsigned sim_config::* fields[] = {
+        &sim_config::l1_size, &sim_config::l1_assoc, &sim_config::l1_block_size,
+        &sim_config::vc_num_blocks, &sim_config::l2_size, &sim_config::l2_assoc
+    };
+    const unsigned num_params = 6;
+
+    std::vector<std::vector<unsigned>> values(num_params);
+    for (unsigned p = 0; p < num_params; p++) {
+        values[p].push_back(base_cfg.*fields[p]);
+    }
+
+    std::string line;
+    unsigned line_num = 0;
+    while (std::getline(file, line))
+    {
+        line_num++;
+
+        // blank lines and comments
+        std::istringstream fields_in(line);
+        std::string name;
+        if (!(fields_in >> name) || name[0] == '#') {
+            continue;
+        }
+
+        unsigned p = 0;
+        while (p < num_params && name != names[p]) {
+            p++;
+        }
+        if (p == num_params)
+        {
+            log.log(&grid_base, verbose::FATAL, path + ": Unknown parameter " + name + " at line " + std::to_string(line_num));
+            return false;
+        }
+
+        values[p].clear();
+        std::string val;
+        while (fields_in >> val)
+        {
+            try {
+                values[p].push_back(parse_number<unsigned>(val));
+            }
+            catch (const std::exception&)
+            {
+                log.log(&grid_base, verbose::FATAL, path + ": Invalid value " + val + " at line " + std::to_string(line_num));
+                return false;
+            }
+        }
+        if (values[p].empty())
+        {
+            log.log(&grid_base, verbose::FATAL, path + ": No values for " + name + " at line " + std::to_string(line_num));
+            return false;
+        }
+    }
+
+    // cartesian product, last parameter fastest
+    std::vector<size_t> idx(num_params, 0);
+    size_t num_invalid = 0;
+    std::string first_invalid;
+    while (true)
+    {
+        sim_config cfg = base_cfg;
+        for (unsigned p = 0; p < num_params; p++) {
+            cfg.*fields[p] = values[p][idx[p]];
+        }
+
+        // without L2 its associativity does not matter, keep only the first
+        bool is_dup = cfg.l2_size == 0 && idx[5] != 0;
+        if (cfg.l2_size == 0) {
+            cfg.l2_assoc = 0;
+        }
+
+        if (!is_dup && cfg.is_valid()) {
+            configs.push_back(cfg);
+        }
+        else if (!is_dup && num_invalid++ == 0)
+        {
+            for (unsigned p = 0; p < num_params; p++) {
+                first_invalid += std::string(p == 0 ? "" : ", ") + names[p] + " " + std::to_string(cfg.*fields[p]);
+            }
+        }
+
+        unsigned p = num_params;
+        while (p > 0 && ++idx[p - 1] == values[p - 1].size())
+        {
+            idx[p - 1] = 0;
+            p--;
+        }
+        if (p == 0) {
+            break;
+        }
+    }
+
+    if (configs.empty())
+    {
+        log.log(&grid_base, verbose::FATAL, path + ": No combination divides into whole sets, e.g. " + first_invalid);
+        return false;
+    }
+    if (num_invalid != 0)
+    {
+        log.log(&grid_base, verbose::WARN, path + ": Skipping " + std::to_string(num_invalid) +
+                " combinations that do not divide into whole sets, e.g. " + first_invalid);
+    }
+
+    return true;
+}
+
+int run_sweep(const std::string& grid_path, const std::string& trace_path, const sim_config& base_cfg,
+    unsigned num_threads, size_t batch_size, cacti_store& cacti, bool is_cacti_prefetch, const stats_paths& out)
+{
+    logger log(verbose::INFO);
+
+    std::vector<sim_config> configs;
+    if (!read_sweep_grid(grid_path, base_cfg, configs, log)) {
+        return 1;
+    }
+
+    // later runs of these configurations find their CACTI results in the store, as does the export
+    if (is_cacti_prefetch || out.is_any())
+    {
+        std::vector<cacti_key> keys;
+        for (const sim_config& cfg : configs)
+        {
+            std::vector<cacti_key> cfg_keys = cacti_keys(cfg);
+            keys.insert(keys.end(), cfg_keys.begin(), cfg_keys.end());
+        }
+        cacti.prefetch(keys, num_threads);
+    }
+
+    // decode once, every hierarchy reads the same requests
+    std::vector<mem_req> reqs;
+    {
+        trace_reader trace(trace_path);
+        if (!trace.is_open())
+        {
+            log.log(&trace, verbose::FATAL, trace_path + ": Unable to find file");
+            return 1;
+        }
+
+        TRACE_STATUS status = trace.read_all(reqs);
+        if (status != TRACE_STATUS::END_OF_TRACE)
+        {
+            log.log(&trace, verbose::FATAL, trace_path + ": Invalid record at line " + std::to_string(trace.get_line()));
+            return 1;
+        }
+    }
+
+    std::vector<sim_result> results(configs.size());
+
+    work_pool pool(num_threads);
+    pool.run(configs.size(), [&](size_t i) {
+        results[i] = simulate(configs[i], reqs, batch_size);
+    });
+
+    std::cout << "l1_size,l1_assoc,l1_block,vc_blocks,l2_size,l2_assoc,"
+              << "l1_reads,l1_read_misses,l1_writes,l1_write_misses,swap_requests,swaps,l1_vc_writebacks,"
+              << "l2_reads,l2_read_misses,l2_writes,l2_write_misses,l2_writebacks,mem_traffic,l1_vc_miss_rate" << std::endl;
+
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+        const sim_config& cfg = configs[i];
+        const sim_result& res = results[i];
+
+        float l1_vc_miss_rate = (res.l1.read_misses + res.l1.write_misses - res.l1.num_swaps) / (float) (res.l1.num_reads + res.l1.num_writes);
+
+        std::cout << cfg.l1_size << "," << cfg.l1_assoc << "," << cfg.l1_block_size << "," << cfg.vc_num_blocks << ","
+                  << cfg.l2_size << "," << cfg.l2_assoc << ","
+                  << res.l1.num_reads << "," << res.l1.read_misses << "," << res.l1.num_writes << "," << res.l1.write_misses << ","
+                  << res.l1.num_swap_req << "," << res.l1.num_swaps << "," << res.l1.num_writebacks << ","
+                  << res.l2.num_reads << "," << res.l2.read_misses << "," << res.l2.num_writes << "," << res.l2.write_misses << ","
+                  << res.l2.num_writebacks << "," << res.mem_traffic << "," << std::setprecision(4) << l1_vc_miss_rate << std::endl;
+    }
+
+    if (out.is_any())
+    {
+        std::vector<stats_run> runs(configs.size());
+        for (size_t i = 0; i < configs.size(); i++)
+        {
+            runs[i].cfg = configs[i];
+            runs[i].res = results[i];
+
+            // a configuration CACTI fails on is exported without metrics
+            sim_figures figs;
+            std::string failed_level;
+            runs[i].has_metrics = get_sim_figures(cacti, configs[i], figs, failed_level);
+            if (runs[i].has_metrics) {
+                runs[i].metrics = compute_metrics(configs[i], results[i], figs);
+            }
+        }
+
+        if (!export_stats(out, runs, log)) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * @file sweep.h
+ * @details This file contains the design space sweep driver
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef SWEEP_H
+#define SWEEP_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// local includes
+#include <common.h>
+#include <message.h>
+#include <perf_counters.h>
+#include <repl_policy.h>
+
+/**
+ * @details One configuration of the simulated hierarchy, as given on the command line
+ */
+struct sim_config
+{
+    unsigned l1_size;
+    unsigned l1_assoc;
+    unsigned l1_block_size;
+    unsigned vc_num_blocks;
+    unsigned l2_size;
+    unsigned l2_assoc;
+
+    REPL_POLICY repl_policy;
+    uint64_t repl_seed;
+
+    sim_config() :
+        l1_size(1024), l1_assoc(2), l1_block_size(16), vc_num_blocks(0), l2_size(0), l2_assoc(0),
+        repl_policy(REPL_POLICY::LRU), repl_seed(1)
+    {
+    }
+
+    /**
+     * @details Check that both levels divide into whole sets
+     */
+    bool is_valid() const;
+};
+
+/**
+ * @details Counters of one simulated configuration
+ */
+struct sim_result
+{
+    perf_counters::cache_counters l1;
+    perf_counters::cache_counters l2;
+    uint64_t mem_traffic;
+};
+
+/**
+ * @details Run one configuration over an already decoded trace, issuing batch_size requests at a time
+ */
+sim_result simulate(const sim_config& cfg, const std::vector<mem_req>& trace, size_t batch_size);
+
+/**
+ * @details Read a grid file of "<parameter> <value> <value> ..." lines, parameters being l1_size,
+ * l1_assoc, l1_block, vc_blocks, l2_size and l2_assoc, and expand it into every valid combination.
+ * Parameters without a line keep their default. Invalid combinations are skipped with a warning.
+ * Returns false on a malformed file or when no combination is valid
+ */
+bool read_sweep_grid(const std::string& path, const sim_config& base_cfg, std::vector<sim_config>& configs, logger& log);
+
+class cacti_store;
+struct stats_paths;
+
+/**
+ * @details Decode the trace once and simulate every configuration of a grid file on num_threads
+ * threads, printing one CSV row per configuration in grid order. With is_cacti_prefetch, the CACTI results
+ * of every organisation in the grid are filled in on the same threads first. Every configuration is also
+ * exported to the files of out, with the metrics CACTI gives for it. Returns the process exit code
+ */
+int run_sweep(const std::string& grid_path, const std::string& trace_path, const sim_config& base_cfg,
+    unsigned num_threads, size_t batch_size, cacti_store& cacti, bool is_cacti_prefetch, const stats_paths& out);
+
+#endif // SWEEP_H
@@ -0,0 +1,300 @@
+/**
+ * @file tag_store.h
+ * @details This file contains the flat structure-of-arrays tag store used by caches
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef TAG_STORE_H
+#define TAG_STORE_H
+
+// standard includes
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+
+// local includes
+#include <checkpoint.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+/**
+ * @details Holds tags and valid/dirty bits of all sets of a cache.
+ * Tags of all sets are laid out back to back in one aligned array with every set padded to
+ * the SIMD width, so the tags of a set are compared against a request in a few vector
+ * instructions. Valid and dirty bits are kept as per set bitmasks.
+ */
+class tag_store
+{
+    public:
+        // tags compared per vector instruction
+#if defined(__AVX2__)
+        static const unsigned SIMD_WAYS = 8;
+#elif defined(__SSE2__)
+        static const unsigned SIMD_WAYS = 4;
+#else
+        static const unsigned SIMD_WAYS = 1;
+#endif
+
+        // way index returned when nothing matches
+        static const int NO_WAY = -1;
+
+    private:
+        unsigned _num_sets;
+        unsigned _assoc;
+
+        // ways per set in the tag array, rounded up to the SIMD width
+        unsigned _stride;
+
+        // 64 bit words of valid/dirty bits per set
+        unsigned _mask_words;
+
+        unsigned* _tags;
+        std::vector<uint64_t> _valid;
+        std::vector<uint64_t> _dirty;
+
+        size_t tag_idx(unsigned set, unsigned way) const {
+            return (size_t) set * _stride + way;
+        }
+
+        size_t mask_idx(unsigned set, unsigned way) const {
+            return (size_t) set * _mask_words + (way >> 6);
+        }
+
+    public:
+
+        /**
+         * @details Construct an all invalid store of num_sets sets with assoc ways each
+         */
+        tag_store(unsigned num_sets, unsigned assoc) :
+            _num_sets(num_sets),
+            _assoc(assoc)
+        {
+            _stride = (assoc + SIMD_WAYS - 1) / SIMD_WAYS * SIMD_WAYS;
+            _mask_words = (assoc + 63) / 64;
+
+            size_t tag_bytes = (size_t) num_sets * _stride * sizeof(unsigned);
+            _tags = nullptr;
+            if (tag_bytes > 0)
+            {
+                // size is a multiple of the SIMD width, so of the alignment as well
+                _tags = static_cast<unsigned*>(std::aligned_alloc(SIMD_WAYS * sizeof(unsigned), tag_bytes));
+                for (size_t i = 0; i < (size_t) num_sets * _stride; i++) {
+                    _tags[i] = 0;
+                }
+            }
+
+            _valid.assign((size_t) num_sets * _mask_words, 0);
+            _dirty.assign((size_t) num_sets * _mask_words, 0);
+        }
+
+        // the tag array is owned, so no copies
+        tag_store(const tag_store&) = delete;
+        tag_store& operator=(const tag_store&) = delete;
+
+        unsigned get_num_sets() const {
+            return _num_sets;
+        }
+
+        unsigned get_assoc() const {
+            return _assoc;
+        }
+
+        unsigned get_mask_words() const {
+            return _mask_words;
+        }
+
+        /**
+         * @details Find the valid way of set holding tag, NO_WAY on a miss
+         */
+        int find(unsigned set, unsigned tag) const
+        {
+            const unsigned* tags = &_tags[tag_idx(set, 0)];
+            const uint64_t* valid = &_valid[mask_idx(set, 0)];
+
+#if defined(__AVX2__)
+            const __m256i key = _mm256_set1_epi32(tag);
+            for (unsigned way = 0; way < _assoc; way += 8)
+            {
+                __m256i cmp = _mm256_cmpeq_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(tags + way)), key);
+                unsigned hits = _mm256_movemask_ps(_mm256_castsi256_ps(cmp));
+                hits &= (unsigned) (valid[way >> 6] >> (way & 63)) & 0xff;
+                if (hits) {
+                    return way + __builtin_ctz(hits);
+                }
+            }
+#elif defined(__SSE2__)
+            const __m128i key = _mm_set1_epi32(tag);
+            for (unsigned way = 0; way < _assoc; way += 4)
+            {
+                __m128i cmp = _mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(tags + way)), key);
+                unsigned hits = _mm_movemask_ps(_mm_castsi128_ps(cmp));
+                hits &= (unsigned) (valid[way >> 6] >> (way & 63)) & 0xf;
+                if (hits) {
+                    return way + __builtin_ctz(hits);
+                }
+            }
+#else
+            for (unsigned way = 0; way < _assoc; way++)
+            {
+                if (tags[way] == tag && ((valid[way >> 6] >> (way & 63)) & 1)) {
+                    return way;
+                }
+            }
+#endif
+            return NO_WAY;
+        }
+
+        /**
+         * @details find() for a store whose associativity is known at compile time, the compare
+         * loop is fully unrolled
+         */
+        template <unsigned ASSOC>
+        int find_fixed(unsigned set, unsigned tag) const
+        {
+            constexpr unsigned stride = (ASSOC + SIMD_WAYS - 1) / SIMD_WAYS * SIMD_WAYS;
+            const unsigned* tags = &_tags[(size_t) set * stride];
+
+            // at most 64 ways, so a single mask word per set
+            uint64_t valid = _valid[set];
+
+#if defined(__AVX2__)
+            const __m256i key = _mm256_set1_epi32(tag);
+            uint64_t hits = 0;
+            for (unsigned way = 0; way < stride; way += 8)
+            {
+                __m256i cmp = _mm256_cmpeq_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(tags + way)), key);
+                hits |= (uint64_t) _mm256_movemask_ps(_mm256_castsi256_ps(cmp)) << way;
+            }
+#elif defined(__SSE2__)
+            const __m128i key = _mm_set1_epi32(tag);
+            uint64_t hits = 0;
+            for (unsigned way = 0; way < stride; way += 4)
+            {
+                __m128i cmp = _mm_cmpeq_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(tags + way)), key);
+                hits |= (uint64_t) _mm_movemask_ps(_mm_castsi128_ps(cmp)) << way;
+            }
+#else
+            uint64_t hits = 0;
+            for (unsigned way = 0; way < ASSOC; way++) {
+                hits |= (uint64_t) (tags[way] == tag) << way;
+            }
+#endif
+            hits &= valid;
+            return hits ? __builtin_ctzll(hits) : NO_WAY;
+        }
+
+        /**
+         * @details find_invalid() for a store of at most 64 ways known at compile time
+         */
+        template <unsigned ASSOC>
+        int find_invalid_fixed(unsigned set) const
+        {
+            constexpr uint64_t all_ways = ASSOC == 64 ? ~0ull : (1ull << ASSOC) - 1;
+            uint64_t free_ways = ~_valid[set] & all_ways;
+            return free_ways ? __builtin_ctzll(free_ways) : NO_WAY;
+        }
+
+        /**
+         * @details Get the first invalid way of set, NO_WAY if the set is full
+         */
+        int find_invalid(unsigned set) const
+        {
+            const uint64_t* valid = &_valid[mask_idx(set, 0)];
+            for (unsigned word = 0; word < _mask_words; word++)
+            {
+                uint64_t free_ways = ~valid[word];
+
+                // ignore bits past the last way
+                unsigned ways_left = _assoc - word * 64;
+                if (ways_left < 64) {
+                    free_ways &= (1ull << ways_left) - 1;
+                }
+
+                if (free_ways) {
+                    return word * 64 + __builtin_ctzll(free_ways);
+                }
+            }
+            return NO_WAY;
+        }
+
+        // line state accessors
+
+        unsigned get_tag(unsigned set, unsigned way) const {
+            return _tags[tag_idx(set, way)];
+        }
+
+        void set_tag(unsigned set, unsigned way, unsigned tag) {
+            _tags[tag_idx(set, way)] = tag;
+        }
+
+        bool is_valid(unsigned set, unsigned way) const {
+            return (_valid[mask_idx(set, way)] >> (way & 63)) & 1;
+        }
+
+        void set_valid(unsigned set, unsigned way, bool valid)
+        {
+            uint64_t bit = 1ull << (way & 63);
+            if (valid) {
+                _valid[mask_idx(set, way)] |= bit;
+            } else {
+                _valid[mask_idx(set, way)] &= ~bit;
+            }
+        }
+
+        bool is_dirty(unsigned set, unsigned way) const {
+            return (_dirty[mask_idx(set, way)] >> (way & 63)) & 1;
+        }
+
+        void set_dirty(unsigned set, unsigned way, bool dirty)
+        {
+            uint64_t bit = 1ull << (way & 63);
+            if (dirty) {
+                _dirty[mask_idx(set, way)] |= bit;
+            } else {
+                _dirty[mask_idx(set, way)] &= ~bit;
+            }
+        }
+
+        /**
+         * @details Write tags and valid/dirty bits, the tags of every set without padding so a
+         * checkpoint does not depend on the SIMD width
+         */
+        void save(ckpt_writer& out) const
+        {
+            out.put(_num_sets);
+            out.put(_assoc);
+            for (unsigned set = 0; set < _num_sets; set++) {
+                out.put_array(&_tags[tag_idx(set, 0)], _assoc);
+            }
+            out.put_vec(_valid);
+            out.put_vec(_dirty);
+        }
+
+        /**
+         * @details Read back what save wrote for a store of the same shape
+         */
+        bool restore(ckpt_reader& in)
+        {
+            if (!in.expect(_num_sets) || !in.expect(_assoc)) {
+                return false;
+            }
+            for (unsigned set = 0; set < _num_sets; set++) {
+                in.get_array(&_tags[tag_idx(set, 0)], _assoc);
+            }
+            in.get_vec(_valid);
+            return in.get_vec(_dirty);
+        }
+
+        /**
+         * @details destructor
+         */
+        ~tag_store()
+        {
+            std::free(_tags);
+        }
+};
+
+#endif // TAG_STORE_H
@@ -0,0 +1,81 @@
+/**
+ * @file trace_bin.cpp
+ * @details This file contains definitions for the binary trace writer
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "trace_bin.h"
+
+#include <cstring>
+
+bin_trace_writer::bin_trace_writer(const std::string& path, uint32_t block_records) :
+    base("Binary trace writer"),
+    _stream(path, std::ios::binary | std::ios::trunc)
+{
+    std::memset(&_header, 0, sizeof(_header));
+    std::memcpy(_header.magic, bin_trace::MAGIC, sizeof(_header.magic));
+    _header.version = bin_trace::VERSION;
+    _header.addr_bits = 8 * sizeof(mem_req::addr);
+    _header.block_records = block_records;
+    _header.num_records = 0;
+
+    _block_count = 0;
+    _prev_addr = 0;
+
+    // reserve space for the header, it is rewritten with the final count on close
+    if (_stream.is_open()) {
+        _stream.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+    }
+}
+
+void bin_trace_writer::put(const mem_req& req)
+{
+    bin_trace::put_varint(_payload, bin_trace::encode(req.req_op_type, req.addr, _prev_addr));
+    _prev_addr = req.addr;
+
+    _block_count = _block_count + 1;
+    _header.num_records = _header.num_records + 1;
+
+    if (_block_count == _header.block_records) {
+        flush_block();
+    }
+}
+
+void bin_trace_writer::flush_block()
+{
+    if (_block_count == 0) {
+        return;
+    }
+
+    bin_trace::block blk;
+    blk.num_records = _block_count;
+    blk.payload_bytes = _payload.size();
+
+    _stream.write(reinterpret_cast<const char*>(&blk), sizeof(blk));
+    _stream.write(reinterpret_cast<const char*>(_payload.data()), _payload.size());
+
+    // deltas restart at every block
+    _payload.clear();
+    _block_count = 0;
+    _prev_addr = 0;
+}
+
+bool bin_trace_writer::close()
+{
+    if (!_stream.is_open()) {
+        return false;
+    }
+
+    flush_block();
+
+    _stream.seekp(0);
+    _stream.write(reinterpret_cast<const char*>(&_header), sizeof(_header));
+    _stream.close();
+
+    return !_stream.fail();
+}
+
+bin_trace_writer::~bin_trace_writer()
+{
+    close();
+}
@@ -0,0 +1,186 @@
+/**
+ * @file trace_bin.h
+ * @details This file contains the layout of the compact binary trace format and its writer
+ *
+ * A binary trace is a bin_trace_header followed by blocks of at most
+ * header.block_records records. Each block starts with a bin_trace_block header
+ * and holds one LEB128 varint per record:
+ *
+ *      (zigzag(addr - prev_addr) << 1) | is_store
+ *
+ * prev_addr restarts at 0 at every block so blocks decode (and can be skipped) on their own.
+ * All fixed width fields are little endian.
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef TRACE_BIN_H
+#define TRACE_BIN_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+// local includes
+#include <base.h>
+#include <message.h>
+
+namespace bin_trace
+{
+    const char MAGIC[8] = {'C', 'S', 'I', 'M', 'T', 'R', 'C', '\0'};
+    const uint16_t VERSION = 1;
+    const uint32_t DEFAULT_BLOCK_RECORDS = 65536;
+
+    // records of a block whose payload, at up to 10 varint bytes a record, still fits payload_bytes
+    const uint32_t MAX_BLOCK_RECORDS = UINT32_MAX / 10;
+
+    /**
+     * @details File header
+     */
+    struct header
+    {
+        char magic[8];
+        uint16_t version;
+        uint8_t addr_bits;
+        uint8_t reserved;
+        uint32_t block_records;
+        uint64_t num_records;
+    };
+
+    /**
+     * @details Per block header
+     */
+    struct block
+    {
+        uint32_t num_records;
+        uint32_t payload_bytes;
+    };
+
+    /**
+     * @details Check if the bytes at data start with a binary trace magic
+     */
+    inline bool has_magic(const char* data, size_t size)
+    {
+        if (size < sizeof(MAGIC)) {
+            return false;
+        }
+        for (size_t i = 0; i < sizeof(MAGIC); i++) {
+            if (data[i] != MAGIC[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @details Pack an access into its unsigned record value
+     */
+    inline uint64_t encode(OP_TYPE op, uint64_t addr, uint64_t prev_addr)
+    {
+        int64_t delta = (int64_t) (addr - prev_addr);
+        uint64_t zigzag = ((uint64_t) delta << 1) ^ (uint64_t) (delta >> 63);
+        return (zigzag << 1) | (op == OP_TYPE::STORE ? 1 : 0);
+    }
+
+    /**
+     * @details Recover operation and address from a record value
+     */
+    inline void decode(uint64_t val, uint64_t& prev_addr, mem_req& req)
+    {
+        req.req_op_type = (val & 1) ? OP_TYPE::STORE : OP_TYPE::LOAD;
+        uint64_t zigzag = val >> 1;
+        int64_t delta = (int64_t) (zigzag >> 1) ^ -(int64_t) (zigzag & 1);
+        prev_addr = prev_addr + delta;
+        req.addr = prev_addr;
+    }
+
+    /**
+     * @details Append val as a varint to buf
+     */
+    inline void put_varint(std::vector<uint8_t>& buf, uint64_t val)
+    {
+        while (val >= 0x80)
+        {
+            buf.push_back((uint8_t) (val | 0x80));
+            val >>= 7;
+        }
+        buf.push_back((uint8_t) val);
+    }
+
+    /**
+     * @details Read a varint at p, not going past end. Returns nullptr on a truncated varint
+     */
+    inline const uint8_t* get_varint(const uint8_t* p, const uint8_t* end, uint64_t& val)
+    {
+        // fast path for the common one byte record
+        if (p != end && *p < 0x80)
+        {
+            val = *p;
+            return p + 1;
+        }
+
+        val = 0;
+        for (unsigned shift = 0; p != end && shift < 64; shift += 7)
+        {
+            uint8_t byte = *p++;
+            val |= (uint64_t) (byte & 0x7f) << shift;
+            if (byte < 0x80) {
+                return p;
+            }
+        }
+        return nullptr;
+    }
+}
+
+/**
+ * @details This class writes accesses out as a binary trace
+ */
+class bin_trace_writer : public base
+{
+    private:
+        std::ofstream _stream;
+        bin_trace::header _header;
+
+        // current block
+        std::vector<uint8_t> _payload;
+        uint32_t _block_count;
+        uint64_t _prev_addr;
+
+        /**
+         * @details Write out the current block
+         */
+        void flush_block();
+
+    public:
+
+        /**
+         * @details Constructor that creates the binary trace at path
+         */
+        bin_trace_writer(const std::string& path, uint32_t block_records = bin_trace::DEFAULT_BLOCK_RECORDS);
+
+        /**
+         * @details Check if the output file could be created
+         */
+        bool is_open() const {
+            return _stream.is_open();
+        }
+
+        /**
+         * @details Append a request to the trace
+         */
+        void put(const mem_req& req);
+
+        /**
+         * @details Flush the last block and finalize the header. False if the trace could not be written out
+         */
+        bool close();
+
+        /**
+         * @details destructor closing the trace if still open
+         */
+        ~bin_trace_writer();
+};
+
+#endif // TRACE_BIN_H
@@ -0,0 +1,111 @@
+/**
+ * @file trace_conv.cpp
+ * @details Converter from "r|w <hex address>" text traces to the binary trace format
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include <iostream>
+#include <string>
+#include <cstdio>
+
+#include <sys/stat.h>
+
+#include <common.h>
+#include <trace_reader.h>
+#include <trace_bin.h>
+
+/**
+ * @details Remove the partial trace at path, leaving devices and pipes written to alone
+ */
+static void remove_partial(const std::string& path)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+        std::remove(path.c_str());
+    }
+}
+
+/**
+ * @details Print how the converter is run
+ */
+static void print_usage(const char* prog)
+{
+    std::cout << "usage: " << prog << " <text trace> <binary trace> [records per block, 1 to "
+              << bin_trace::MAX_BLOCK_RECORDS << "]" << std::endl;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3 || argc > 4)
+    {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    std::string in_path = argv[1];
+    std::string out_path = argv[2];
+
+    uint32_t block_records = bin_trace::DEFAULT_BLOCK_RECORDS;
+    if (argc > 3)
+    {
+        try {
+            block_records = parse_number<uint32_t>(argv[3]);
+        }
+        catch (const std::logic_error&) {
+            block_records = 0;
+        }
+
+        if (block_records == 0 || block_records > bin_trace::MAX_BLOCK_RECORDS)
+        {
+            std::cout << "FATAL: " << argv[3] << ": records per block must be a whole number from 1 to "
+                      << bin_trace::MAX_BLOCK_RECORDS << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    logger log(verbose::INFO);
+
+    trace_reader trace(in_path);
+    if (!trace.is_open())
+    {
+        log.log(&trace, verbose::FATAL, in_path + ": Unable to find file");
+        return 1;
+    }
+
+    bin_trace_writer writer(out_path, block_records);
+    if (!writer.is_open())
+    {
+        log.log(&writer, verbose::FATAL, out_path + ": Unable to create file");
+        return 1;
+    }
+
+    mem_req req;
+    TRACE_STATUS status;
+    uint64_t count = 0;
+    while ((status = trace.next(req)) == TRACE_STATUS::VALID)
+    {
+        writer.put(req);
+        count = count + 1;
+    }
+
+    // a partial trace is not left behind to be replayed as if it were whole
+    if (status != TRACE_STATUS::END_OF_TRACE)
+    {
+        log.log(&trace, verbose::FATAL, in_path + ": Invalid record at line " + std::to_string(trace.get_line()));
+        writer.close();
+        remove_partial(out_path);
+        return 1;
+    }
+
+    if (!writer.close())
+    {
+        log.log(&writer, verbose::FATAL, out_path + ": Unable to write file");
+        remove_partial(out_path);
+        return 1;
+    }
+
+    log.log(&writer, verbose::INFO, "Wrote " + std::to_string(count) + " records to " + out_path);
+
+    return 0;
+}
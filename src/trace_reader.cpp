@@ -0,0 +1,311 @@
+/**
+ * @file trace_reader.cpp
+ * @details This file contains definitions for the memory mapped trace reader
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#include "trace_reader.h"
+#include "trace_bin.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace
+{
+    // hex digit value of every byte, 0xff for non-hex characters
+    struct hex_table
+    {
+        unsigned char val[256];
+
+        hex_table()
+        {
+            for (unsigned i = 0; i < 256; i++) {
+                val[i] = 0xff;
+            }
+            for (unsigned i = 0; i < 10; i++) {
+                val['0' + i] = i;
+            }
+            for (unsigned i = 0; i < 6; i++) {
+                val['a' + i] = 10 + i;
+                val['A' + i] = 10 + i;
+            }
+        }
+    };
+
+    const hex_table hex_lut;
+
+    // same character class as the stream extraction operator
+    inline bool is_space(char c)
+    {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    inline bool is_token_end(const char* p, const char* end)
+    {
+        return p == end || is_space(*p) || *p == '\n';
+    }
+}
+
+trace_reader::trace_reader(const std::string& path) : base("Trace"), _path(path)
+{
+    _data = nullptr;
+    _size = 0;
+    _is_open = false;
+    _line = 0;
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        struct stat st;
+        if (fstat(fd, &st) == 0)
+        {
+            _is_open = true;
+            _size = st.st_size;
+
+            // mmap refuses empty mappings, an empty trace simply has no records
+            if (_size > 0)
+            {
+                void* map = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (map != MAP_FAILED)
+                {
+                    _data = static_cast<const char*>(map);
+                    madvise(map, _size, MADV_SEQUENTIAL);
+                }
+                else {
+                    _is_open = false;
+                    _size = 0;
+                }
+            }
+        }
+        close(fd);
+    }
+
+    _pos = _data;
+    _end = _data + _size;
+
+    // select the decoder by file magic
+    _is_binary = bin_trace::has_magic(_data, _size);
+    _is_corrupt = false;
+    _block_left = 0;
+    _prev_addr = 0;
+
+    if (_is_binary)
+    {
+        // a bad header is reported on the first read
+        bin_trace::header hdr;
+        if (_size < sizeof(hdr)) {
+            _is_corrupt = true;
+        }
+        else
+        {
+            std::memcpy(&hdr, _data, sizeof(hdr));
+            _pos = _data + sizeof(hdr);
+            _is_corrupt = hdr.version != bin_trace::VERSION || hdr.addr_bits > 64;
+        }
+    }
+}
+
+TRACE_STATUS trace_reader::next_text(mem_req& req)
+{
+    if (_pos == _end) {
+        return TRACE_STATUS::END_OF_TRACE;
+    }
+
+    _line = _line + 1;
+
+    const char* p = _pos;
+
+    // find end of this line and move the cursor past it
+    const char* eol = static_cast<const char*>(memchr(p, '\n', _end - p));
+    if (eol == nullptr) {
+        eol = _end;
+        _pos = _end;
+    }
+    else {
+        _pos = eol + 1;
+    }
+
+    // get opr type
+    while (p != eol && is_space(*p)) {
+        p++;
+    }
+
+    if (p == eol || !is_token_end(p + 1, eol)) {
+        return TRACE_STATUS::INVALID_OP;
+    }
+
+    if (*p == 'r') {
+        req.req_op_type = OP_TYPE::LOAD;
+    }
+    else if (*p == 'w') {
+        req.req_op_type = OP_TYPE::STORE;
+    }
+    else {
+        return TRACE_STATUS::INVALID_OP;
+    }
+    p++;
+
+    // get address
+    while (p != eol && is_space(*p)) {
+        p++;
+    }
+
+    // optional 0x prefix, only when digits follow it
+    if (eol - p > 2 && p[0] == '0' && (p[1] == 'x' || p[1] == 'X') && hex_lut.val[(unsigned char) p[2]] != 0xff) {
+        p += 2;
+    }
+
+    if (p == eol || hex_lut.val[(unsigned char) *p] == 0xff) {
+        return TRACE_STATUS::INVALID_ADDR;
+    }
+
+    unsigned long addr = 0;
+    unsigned char digit;
+    while (p != eol && (digit = hex_lut.val[(unsigned char) *p]) != 0xff)
+    {
+        addr = (addr << 4) | digit;
+        p++;
+    }
+
+    req.addr = addr;
+
+    return TRACE_STATUS::VALID;
+}
+
+TRACE_STATUS trace_reader::next_binary(mem_req& req)
+{
+    if (_is_corrupt) {
+        return TRACE_STATUS::CORRUPT;
+    }
+
+    // step into the next block
+    while (_block_left == 0)
+    {
+        if (_pos == _end) {
+            return TRACE_STATUS::END_OF_TRACE;
+        }
+
+        bin_trace::block blk;
+        if ((size_t) (_end - _pos) < sizeof(blk)) {
+            return TRACE_STATUS::CORRUPT;
+        }
+        std::memcpy(&blk, _pos, sizeof(blk));
+        _pos += sizeof(blk);
+
+        if ((size_t) (_end - _pos) < blk.payload_bytes) {
+            return TRACE_STATUS::CORRUPT;
+        }
+
+        _block_left = blk.num_records;
+        _prev_addr = 0;
+    }
+
+    _line = _line + 1;
+
+    uint64_t val;
+    const uint8_t* p = bin_trace::get_varint(reinterpret_cast<const uint8_t*>(_pos), reinterpret_cast<const uint8_t*>(_end), val);
+    if (p == nullptr) {
+        return TRACE_STATUS::CORRUPT;
+    }
+    _pos = reinterpret_cast<const char*>(p);
+
+    bin_trace::decode(val, _prev_addr, req);
+    _block_left = _block_left - 1;
+
+    return TRACE_STATUS::VALID;
+}
+
+uint64_t trace_reader::get_sample_hash() const
+{
+    // FNV-1a over the head and the tail, which overlap in a small file
+    uint64_t hash = 0xcbf29ce484222325ull;
+    auto mix = [&](const char* begin, const char* end)
+    {
+        for (const char* p = begin; p != end; p++) {
+            hash = (hash ^ (uint8_t) *p) * 0x100000001b3ull;
+        }
+    };
+
+    size_t sample = std::min(_size, SAMPLE_HASH_BYTES);
+    mix(_data, _data + sample);
+    mix(_data + _size - sample, _data + _size);
+
+    return hash;
+}
+
+TRACE_STATUS trace_reader::skip(uint64_t num)
+{
+    if (!_is_binary)
+    {
+        for (; num > 0; num--)
+        {
+            if (_pos == _end) {
+                return TRACE_STATUS::END_OF_TRACE;
+            }
+
+            const char* eol = static_cast<const char*>(memchr(_pos, '\n', _end - _pos));
+            _pos = eol != nullptr ? eol + 1 : _end;
+            _line = _line + 1;
+        }
+        return TRACE_STATUS::VALID;
+    }
+
+    if (_is_corrupt) {
+        return TRACE_STATUS::CORRUPT;
+    }
+
+    mem_req req;
+    while (num > 0)
+    {
+        // blocks ending before the target are never decoded
+        if (_block_left == 0 && _pos != _end)
+        {
+            bin_trace::block blk;
+            if ((size_t) (_end - _pos) < sizeof(blk)) {
+                return TRACE_STATUS::CORRUPT;
+            }
+            std::memcpy(&blk, _pos, sizeof(blk));
+
+            if (blk.num_records <= num)
+            {
+                if ((size_t) (_end - _pos) - sizeof(blk) < blk.payload_bytes) {
+                    return TRACE_STATUS::CORRUPT;
+                }
+                _pos += sizeof(blk) + blk.payload_bytes;
+                _line = _line + blk.num_records;
+                num -= blk.num_records;
+                continue;
+            }
+        }
+
+        TRACE_STATUS status = next_binary(req);
+        if (status != TRACE_STATUS::VALID) {
+            return status;
+        }
+        num--;
+    }
+
+    return TRACE_STATUS::VALID;
+}
+
+TRACE_STATUS trace_reader::read_all(std::vector<mem_req>& reqs)
+{
+    mem_req req;
+    TRACE_STATUS status;
+    while ((status = next(req)) == TRACE_STATUS::VALID) {
+        reqs.push_back(req);
+    }
+    return status;
+}
+
+trace_reader::~trace_reader()
+{
+    if (_data != nullptr) {
+        munmap(const_cast<char*>(_data), _size);
+    }
+}
@@ -0,0 +1,152 @@
+/**
+ * @file trace_reader.h
+ * @details This file contains the class declaration for a memory mapped trace reader
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef TRACE_READER_H
+#define TRACE_READER_H
+
+// standard includes
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// local includes
+#include <base.h>
+#include <message.h>
+
+/**
+ * @details Enumerates outcomes of decoding a trace record
+ */
+enum TRACE_STATUS
+{
+    VALID,
+    END_OF_TRACE,
+    INVALID_OP,
+    INVALID_ADDR,
+    CORRUPT,
+};
+
+/**
+ * @details This class maps a trace file into memory and decodes records directly out of the
+ * mapped bytes without building per line strings or streams. Both the "r|w <hex address>" text
+ * format and the binary format of trace_bin.h are understood, the latter is selected by its magic
+ */
+class trace_reader : public base
+{
+    private:
+        std::string _path;
+
+        // mapping
+        const char* _data;
+        size_t _size;
+        bool _is_open;
+
+        // cursor into mapped bytes
+        const char* _pos;
+        const char* _end;
+
+        // number of the last line (text) or record (binary) decoded (1-based)
+        uint64_t _line;
+
+        // binary trace state
+        bool _is_binary;
+        bool _is_corrupt;
+        uint32_t _block_left;
+        uint64_t _prev_addr;
+
+        /**
+         * @details Decode the next record of a text trace
+         */
+        TRACE_STATUS next_text(mem_req& req);
+
+        /**
+         * @details Decode the next record of a binary trace
+         */
+        TRACE_STATUS next_binary(mem_req& req);
+
+    public:
+
+        // bytes at either end of the file the sampled hash covers
+        static const size_t SAMPLE_HASH_BYTES = 1 << 20;
+
+        /**
+         * @details Constructor that maps the trace file at path
+         */
+        trace_reader(const std::string& path);
+
+        // the mapping is owned, so no copies
+        trace_reader(const trace_reader&) = delete;
+        trace_reader& operator=(const trace_reader&) = delete;
+
+        /**
+         * @details Check if the trace file was found and mapped
+         */
+        bool is_open() const {
+            return _is_open;
+        }
+
+        /**
+         * @details Check if the trace is in the binary format
+         */
+        bool is_binary() const {
+            return _is_binary;
+        }
+
+        /**
+         * @details Line number (text) or record number (binary) of the last record handed out by next()
+         */
+        uint64_t get_line() const {
+            return _line;
+        }
+
+        /**
+         * @details Bytes of the file consumed so far, a whole block at a time in a binary trace
+         */
+        size_t get_offset() const {
+            return _pos - _data;
+        }
+
+        /**
+         * @details Size of the file in bytes
+         */
+        size_t get_size() const {
+            return _size;
+        }
+
+        /**
+         * @details Hash of the first and last SAMPLE_HASH_BYTES of the file, which along with its size
+         * tells traces apart without reading all of them
+         */
+        uint64_t get_sample_hash() const;
+
+        /**
+         * @details Decode the next record into req
+         */
+        TRACE_STATUS next(mem_req& req)
+        {
+            return _is_binary ? next_binary(req) : next_text(req);
+        }
+
+        /**
+         * @details Move past the next num records without handing them out. Whole blocks of a binary
+         * trace are stepped over by their headers, text lines by their line ends, without checking
+         * them. Returns VALID once all were skipped, END_OF_TRACE if the trace ended first
+         */
+        TRACE_STATUS skip(uint64_t num);
+
+        /**
+         * @details Decode all remaining records into reqs. Returns END_OF_TRACE once the whole trace
+         * was read, the failing status otherwise
+         */
+        TRACE_STATUS read_all(std::vector<mem_req>& reqs);
+
+        /**
+         * @details destructor unmapping the trace file
+         */
+        ~trace_reader();
+};
+
+#endif // TRACE_READER_H
@@ -0,0 +1,142 @@
+/**
+ * @file work_pool.h
+ * @details This file contains a work-stealing pool for running independent tasks on all cores
+ * @author Edwin Joy <edwin7026@gmail.com>
+ */
+
+#ifndef WORK_POOL_H
+#define WORK_POOL_H
+
+// standard includes
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * @details Runs tasks 0..n-1 on a fixed number of threads. Every thread starts with a contiguous
+ * share of the tasks in its own queue, takes work from the front of it and steals from the back of
+ * other queues once it runs dry, so long and short tasks even out without a central queue
+ */
+class work_pool
+{
+    private:
+        // per thread queue on its own cache line
+        struct alignas(64) task_queue
+        {
+            std::mutex lock;
+            std::deque<size_t> tasks;
+        };
+
+        unsigned _num_threads;
+        std::atomic<unsigned long> _steals;
+
+        bool pop(task_queue& queue, size_t& task)
+        {
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (queue.tasks.empty()) {
+                return false;
+            }
+            task = queue.tasks.front();
+            queue.tasks.pop_front();
+            return true;
+        }
+
+        bool steal(task_queue& queue, size_t& task)
+        {
+            std::lock_guard<std::mutex> guard(queue.lock);
+            if (queue.tasks.empty()) {
+                return false;
+            }
+            task = queue.tasks.back();
+            queue.tasks.pop_back();
+            return true;
+        }
+
+    public:
+
+        /**
+         * @details Construct a pool of num_threads threads, 0 uses one per hardware thread
+         */
+        work_pool(unsigned num_threads) : _steals(0)
+        {
+            if (num_threads == 0) {
+                num_threads = std::thread::hardware_concurrency();
+            }
+            _num_threads = num_threads > 0 ? num_threads : 1;
+        }
+
+        unsigned get_num_threads() const {
+            return _num_threads;
+        }
+
+        /**
+         * @details Number of tasks taken from another thread's queue so far
+         */
+        unsigned long get_steals() const {
+            return _steals.load();
+        }
+
+        /**
+         * @details Call task_fn(i) for every i below num_tasks and return once all calls are done.
+         * Tasks are not added while running, so a thread finding every queue empty is finished
+         */
+        template <typename FN>
+        void run(size_t num_tasks, FN task_fn)
+        {
+            unsigned num_threads = num_tasks < _num_threads ? (unsigned) num_tasks : _num_threads;
+            if (num_threads == 0) {
+                return;
+            }
+
+            std::unique_ptr<task_queue[]> queues(new task_queue[num_threads]);
+            for (unsigned t = 0; t < num_threads; t++)
+            {
+                for (size_t i = num_tasks * t / num_threads; i < num_tasks * (t + 1) / num_threads; i++) {
+                    queues[t].tasks.push_back(i);
+                }
+            }
+
+            auto worker = [&](unsigned self)
+            {
+                size_t task;
+                while (true)
+                {
+                    if (pop(queues[self], task))
+                    {
+                        task_fn(task);
+                        continue;
+                    }
+
+                    // own queue is dry, look through the others once
+                    bool found = false;
+                    for (unsigned k = 1; k < num_threads && !found; k++) {
+                        found = steal(queues[(self + k) % num_threads], task);
+                    }
+                    if (!found) {
+                        return;
+                    }
+
+                    _steals++;
+                    task_fn(task);
+                }
+            };
+
+            std::vector<std::thread> threads;
+            for (unsigned t = 1; t < num_threads; t++) {
+                threads.emplace_back(worker, t);
+            }
+
+            // the calling thread works as well
+            worker(0);
+
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+};
+
+#endif // WORK_POOL_H
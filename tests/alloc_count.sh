@@ -0,0 +1,32 @@
+#!/bin/sh
+# Steady-state allocations: once the warm-up records were issued, the request path of every way of
+# running a trace sends the rest of it without a single heap allocation.
+# usage: alloc_count.sh <cache_sim>
+
+SIM=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR" || exit 1
+
+fail() {
+    echo "FAIL: $1"
+    exit 1
+}
+
+# reads and writes spread over 1 MB, well past the 65536 warm-up records
+awk 'BEGIN {
+    x = 12345
+    for (i = 0; i < 200000; i++) {
+        x = (x * 1103515245 + 12345) % 2147483648
+        printf "%s %x\n", (x % 4 == 0) ? "w" : "r", 1073741824 + (x % 1048576)
+    }
+}' > trace.txt
+
+for mode in "" "--batch=0" "--batch=0 --dynamic" "--batch=7" "--pipeline" "--async"; do
+    # shellcheck disable=SC2086
+    "$SIM" 1024 2 16 8 8192 4 trace.txt --cacti=table --count-allocs $mode > out.txt 2>&1 || fail "run failed with '$mode'"
+    grep -q "Heap allocations after the first 65536 records: 0$" out.txt ||
+        fail "steady state allocated with '$mode': $(grep "Heap allocations after" out.txt)"
+done
+
+echo "alloc_count: ok"
@@ -0,0 +1,50 @@
+#!/bin/sh
+# CACTI store: a CACTI that cannot run fails the run without being stored, so the run recovers once
+# CACTI is there, while organisations CACTI rejects stay rejected.
+# usage: cacti_store.sh <cache_sim>
+
+SIM=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR" || exit 1
+
+fail() {
+    echo "FAIL: $1"
+    exit 1
+}
+
+printf 'r 400341a0\nw 400341b0\nr 400341a0\n' > trace.txt
+run() {
+    "$SIM" "$1" 2 16 0 0 0 trace.txt --cacti=exact --cacti-store=store.txt > out.txt 2>&1
+}
+
+# failure lines older stores wrote for a missing CACTI are not read
+echo "1024 16 2 45nm 3 0 0 0" > store.txt
+
+# no CACTI binary: the run fails and nothing is stored
+run 1024 && fail "run without CACTI succeeded"
+[ "$(wc -l < store.txt)" -eq 1 ] || fail "failure of a missing CACTI was stored"
+
+# CACTI appears: the same run recovers and stores the figures
+cat > cacti <<'SCRIPT'
+#!/bin/sh
+if [ "$1" = 2048 ]; then
+    echo "ERROR: no valid data array organizations found"
+    exit 1
+fi
+echo "Access time (ns): 0.25"
+echo "Total dynamic read energy per access (nJ):0.01"
+echo "Cache height x width (mm): 0.2 x 0.3"
+SCRIPT
+chmod +x cacti
+run 1024 || fail "run did not recover once CACTI was there"
+grep -q "^1024 16 2 45nm 0 " store.txt || fail "figures were not stored"
+
+# an organisation CACTI rejects is stored as such and not run again
+run 2048 && fail "run of a rejected organisation succeeded"
+grep -q "^2048 16 2 45nm 4 " store.txt || fail "rejection was not stored"
+rm cacti
+run 2048 && fail "stored rejection was not kept"
+grep -q "CACTI failed on L1" out.txt || fail "stored rejection was not reported"
+
+echo "cacti_store: ok"
@@ -0,0 +1,36 @@
+#!/bin/sh
+# Shared L2: the L2 of a multi-core run looks up a quantum of requests as one batch. With the other
+# core idle it has to count what the L2 of a single core run counts, whatever the quantum.
+# usage: shared_l2.sh <cache_sim>
+
+SIM=$(cd "$(dirname "$1")" && pwd)/$(basename "$1")
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+cd "$DIR" || exit 1
+
+fail() {
+    echo "FAIL: $1"
+    exit 1
+}
+
+# reads and writes over 64 KiB, enough to miss in both levels
+awk 'BEGIN { srand(1); for (i = 0; i < 20000; i++) printf "%s %x\n", rand() < 0.3 ? "w" : "r", int(rand() * 65536) }' > trace.txt
+: > idle.txt
+
+# L2 counters and memory traffic, without the letters the two reports number them by
+l2_counters() {
+    sed 's/^ *\([a-z]\. \)\{0,1\}//' "$1" |
+        grep -E '^(number of L2 (reads|read misses|writes|write misses)|number of writebacks from L2|total memory traffic):'
+}
+
+"$SIM" 1024 2 16 0 8192 4 trace.txt --cacti=table > single.txt 2>&1 || fail "single core run failed"
+l2_counters single.txt > expected.txt
+[ "$(wc -l < expected.txt)" -eq 6 ] || fail "L2 counters not found in the single core report"
+
+for quantum in 1 7 10000; do
+    "$SIM" 1024 2 16 0 8192 4 trace.txt --cacti=table --core-trace=idle.txt --quantum=$quantum > multi.txt 2>&1 ||
+        fail "multi-core run failed with quantum $quantum"
+    l2_counters multi.txt | diff expected.txt - > /dev/null || fail "shared L2 differs from a single core with quantum $quantum"
+done
+
+echo "shared_l2: ok"